@@ -0,0 +1,295 @@
+#include "pch.h"
+#include <malloc.h>
+#include "DoubleSeaDeque.h"
+#include "DoubleSeaPlatform.h"
+
+// __________________________ Prototypes __________________________
+
+static DSL_DequeArray *_CreateDequeArray(int64_t capacity);
+static DSL_DequeArray *_GrowDequeArray(DSL_Deque *pDeque, DSL_DequeArray *pArray, int64_t bottom, int64_t top);
+
+// __________________________ Functions __________________________
+
+/**
+ * @brief DSL_InitDeque initializes a work-stealing deque
+ *
+ * @param pDeque - A pointer to the deque that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param capacity - The initial number of slots, rounded up to a power of two
+ * @return int - 1 on success, 0 if the buffer could not be allocated
+ */
+int DSL_InitDeque(DSL_Deque *pDeque, size_t offset, size_t capacity)
+{
+	if (!pDeque)
+	{
+		return 0;
+	}
+
+	int64_t slots = 16;
+	while ((size_t)slots < capacity)
+	{
+		slots <<= 1;
+	}
+
+	DSL_DequeArray *pArray = _CreateDequeArray(slots);
+	if (!pArray)
+	{
+		return 0;
+	}
+
+	pDeque->top = 0;
+	pDeque->bottom = 0;
+	pDeque->pArray = pArray;
+	pDeque->offset = offset == -1 ? OFFSETOF_DSL_NODE : offset;
+	return 1;
+}
+
+/**
+ * @brief DSL_DestroyDeque releases the buffers of a deque
+ *
+ * The nodes still in the deque are not touched. No other thread may be using the deque.
+ *
+ * @param pDeque - A pointer to the deque that will be destroyed
+ */
+void DSL_DestroyDeque(DSL_Deque *pDeque)
+{
+	if (!pDeque)
+	{
+		return;
+	}
+
+	DSL_DequeArray *pArray = pDeque->pArray;
+	while (pArray)
+	{
+		DSL_DequeArray *pRetired = pArray->pRetired;
+		free(pArray);
+		pArray = pRetired;
+	}
+
+	pDeque->top = 0;
+	pDeque->bottom = 0;
+	pDeque->pArray = NULL;
+}
+
+/**
+ * @brief DSL_DequePush adds a node to the bottom of the deque
+ *
+ * Owner thread only. The buffer doubles when it is full.
+ *
+ * @param pDeque - A pointer to the deque the node will be added to
+ * @param pNode - A pointer to the node that will be added
+ * @return int - 1 on success, 0 if the buffer could not grow
+ */
+int DSL_DequePush(DSL_Deque *pDeque, void *pNode)
+{
+	if (!pDeque || !pNode)
+	{
+		return 0;
+	}
+
+	int64_t bottom = DSL_LoadRelaxed64(&pDeque->bottom);
+	int64_t top = DSL_LoadAcquire64(&pDeque->top);
+	DSL_DequeArray *pArray = DSL_LoadPointerRelaxed(&pDeque->pArray);
+
+	if (bottom - top > pArray->capacity - 1)
+	{
+		pArray = _GrowDequeArray(pDeque, pArray, bottom, top);
+		if (!pArray)
+		{
+			return 0;
+		}
+	}
+
+	DSL_StorePointerRelaxed(&pArray->slots[bottom & (pArray->capacity - 1)], pNode);
+	// publish the slot before thieves can see the new bottom
+	DSL_StoreRelease64(&pDeque->bottom, bottom + 1);
+	return 1;
+}
+
+/**
+ * @brief DSL_DequePop removes the most recently pushed node
+ *
+ * Owner thread only.
+ *
+ * @param pDeque - A pointer to the deque the node will be removed from
+ * @return void* - A pointer to the removed node, or NULL if the deque is empty
+ */
+void *DSL_DequePop(DSL_Deque *pDeque)
+{
+	if (!pDeque)
+	{
+		return NULL;
+	}
+
+	int64_t bottom = DSL_LoadRelaxed64(&pDeque->bottom) - 1;
+	DSL_DequeArray *pArray = DSL_LoadPointerRelaxed(&pDeque->pArray);
+
+	// claim the bottom slot before looking at top, thieves do the opposite
+	DSL_StoreRelaxed64(&pDeque->bottom, bottom);
+	DSL_FenceSeqCst();
+	int64_t top = DSL_LoadRelaxed64(&pDeque->top);
+
+	if (top > bottom)
+	{
+		// empty, undo the claim
+		DSL_StoreRelaxed64(&pDeque->bottom, bottom + 1);
+		return NULL;
+	}
+
+	void *pNode = DSL_LoadPointerRelaxed(&pArray->slots[bottom & (pArray->capacity - 1)]);
+
+	if (top == bottom)
+	{
+		// last node, race the thieves for it through top
+		if (!DSL_CompareExchange64(&pDeque->top, top, top + 1))
+		{
+			pNode = NULL;
+		}
+		DSL_StoreRelaxed64(&pDeque->bottom, bottom + 1);
+	}
+
+	return pNode;
+}
+
+/**
+ * @brief DSL_DequeSteal removes the oldest node from the deque
+ *
+ * Safe to call from any thread. A NULL result means the deque was empty or another
+ * thread won the race for the node, callers usually move on to another victim.
+ *
+ * @param pDeque - A pointer to the deque the node will be stolen from
+ * @return void* - A pointer to the stolen node, or NULL
+ */
+void *DSL_DequeSteal(DSL_Deque *pDeque)
+{
+	if (!pDeque)
+	{
+		return NULL;
+	}
+
+	int64_t top = DSL_LoadAcquire64(&pDeque->top);
+	DSL_FenceSeqCst();
+	int64_t bottom = DSL_LoadAcquire64(&pDeque->bottom);
+
+	if (top >= bottom)
+	{
+		return NULL;
+	}
+
+	DSL_DequeArray *pArray = DSL_LoadPointerAcquire(&pDeque->pArray);
+	void *pNode = DSL_LoadPointerRelaxed(&pArray->slots[top & (pArray->capacity - 1)]);
+
+	// the node is only ours if nobody else moved top first
+	if (!DSL_CompareExchange64(&pDeque->top, top, top + 1))
+	{
+		return NULL;
+	}
+
+	return pNode;
+}
+
+/**
+ * @brief DSL_DequeSize returns the number of nodes in the deque
+ *
+ * The value is a snapshot and may be stale by the time it is used.
+ *
+ * @param pDeque - A pointer to the deque
+ * @return size_t - The number of nodes in the deque
+ */
+size_t DSL_DequeSize(DSL_Deque *pDeque)
+{
+	if (!pDeque)
+	{
+		return 0;
+	}
+
+	int64_t top = DSL_LoadAcquire64(&pDeque->top);
+	int64_t bottom = DSL_LoadAcquire64(&pDeque->bottom);
+	return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+/**
+ * @brief DSL_DequePushList moves every node of a list into the deque
+ *
+ * Owner thread only. Nodes are pushed head first, so the head is the first to be stolen.
+ * The list must use the same offset as the deque.
+ *
+ * @param pDeque - A pointer to the deque the nodes will be added to
+ * @param pFromList - A pointer to the list the nodes will be taken from
+ * @return size_t - The number of nodes moved
+ */
+size_t DSL_DequePushList(DSL_Deque *pDeque, DSL_List *pFromList)
+{
+	if (!pDeque || !pFromList || pFromList->offset != pDeque->offset)
+	{
+		return 0;
+	}
+
+	size_t moved = 0;
+	void *pNode;
+
+	// a pushed node can be stolen right away, so it has to be off the list before it is published
+	while ((pNode = DSL_Pop(pFromList)) != NULL)
+	{
+		if (!DSL_DequePush(pDeque, pNode))
+		{
+			DSL_Push(pNode, pFromList);
+			break;
+		}
+
+		moved++;
+	}
+
+	return moved;
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Allocates an empty circular buffer.
+ *
+ * @param capacity The number of slots, a power of two.
+ * @return Pointer to the buffer, or NULL if the allocation failed.
+ */
+static DSL_DequeArray *_CreateDequeArray(int64_t capacity)
+{
+	DSL_DequeArray *pArray = malloc(sizeof(DSL_DequeArray) + ((size_t)capacity * sizeof(void *)));
+	if (!pArray)
+	{
+		return NULL;
+	}
+
+	pArray->capacity = capacity;
+	pArray->pRetired = NULL;
+	return pArray;
+}
+
+/**
+ * @brief Replaces the buffer of a deque with one twice the size.
+ *
+ * Owner thread only. The live range [top, bottom) keeps its indices, and the old buffer
+ * stays readable for thieves until the deque is destroyed.
+ *
+ * @param pDeque Pointer to the deque.
+ * @param pArray Pointer to the current buffer.
+ * @param bottom The owner's bottom index.
+ * @param top The top index observed by the owner.
+ * @return Pointer to the new buffer, or NULL if the allocation failed.
+ */
+static DSL_DequeArray *_GrowDequeArray(DSL_Deque *pDeque, DSL_DequeArray *pArray, int64_t bottom, int64_t top)
+{
+	DSL_DequeArray *pGrown = _CreateDequeArray(pArray->capacity * 2);
+	if (!pGrown)
+	{
+		return NULL;
+	}
+
+	for (int64_t i = top; i < bottom; i++)
+	{
+		pGrown->slots[i & (pGrown->capacity - 1)] = pArray->slots[i & (pArray->capacity - 1)];
+	}
+
+	pGrown->pRetired = pArray;
+	DSL_StorePointerRelease(&pDeque->pArray, pGrown);
+	return pGrown;
+}
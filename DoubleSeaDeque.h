@@ -0,0 +1,121 @@
+#pragma once
+
+#ifndef DOUBLE_SEA_DEQUE_H
+#define DOUBLE_SEA_DEQUE_H
+#include "DoubleSeaLib.h"
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief DSL_DequeArray is the circular buffer behind a DSL_Deque.
+ *
+ * @param capacity The number of slots, always a power of two.
+ * @param pRetired A pointer to the smaller buffer this one replaced, kept until the deque
+ * 		   is destroyed because thieves may still be reading from it.
+ * @param slots The node pointers held by the deque.
+ */
+typedef struct DSL_DequeArray
+{
+	int64_t capacity;
+	struct DSL_DequeArray *pRetired;
+	void *volatile slots[];
+} DSL_DequeArray;
+
+/**
+ * @brief DSL_Deque is a Chase-Lev work-stealing deque of intrusive nodes.
+ *
+ * The owning thread pushes and pops at the bottom without locks, any other thread may
+ * steal from the top. Nodes are held by pointer, so their links are free while they are
+ * in the deque and they can move straight on to a DSL_List with the same offset.
+ *
+ * @param top The index thieves steal from.
+ * @param bottom The index the owner pushes to and pops from.
+ * @param pArray A pointer to the current circular buffer.
+ * @param offset The offset to the pNext pointer in the nodes.
+ */
+typedef struct DSL_Deque
+{
+	volatile int64_t top;
+	char topPadding[DSL_CACHE_LINE_SIZE - sizeof(int64_t)];
+	volatile int64_t bottom;
+	char bottomPadding[DSL_CACHE_LINE_SIZE - sizeof(int64_t)];
+	DSL_DequeArray *volatile pArray;
+	size_t offset;
+} DSL_Deque;
+
+// __________________________ Function Prototypes __________________________
+
+/**
+ * @brief DSL_InitDeque initializes a work-stealing deque
+ *
+ * @param pDeque - A pointer to the deque that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param capacity - The initial number of slots, rounded up to a power of two
+ * @return int - 1 on success, 0 if the buffer could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_InitDeque(DSL_Deque *pDeque, size_t offset, size_t capacity);
+
+/**
+ * @brief DSL_DestroyDeque releases the buffers of a deque
+ *
+ * The nodes still in the deque are not touched. No other thread may be using the deque.
+ *
+ * @param pDeque - A pointer to the deque that will be destroyed
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroyDeque(DSL_Deque *pDeque);
+
+/**
+ * @brief DSL_DequePush adds a node to the bottom of the deque
+ *
+ * Owner thread only. The buffer doubles when it is full.
+ *
+ * @param pDeque - A pointer to the deque the node will be added to
+ * @param pNode - A pointer to the node that will be added
+ * @return int - 1 on success, 0 if the buffer could not grow
+ */
+DOUBLE_SEA_LIB_API int DSL_DequePush(DSL_Deque *pDeque, void *pNode);
+
+/**
+ * @brief DSL_DequePop removes the most recently pushed node
+ *
+ * Owner thread only.
+ *
+ * @param pDeque - A pointer to the deque the node will be removed from
+ * @return void* - A pointer to the removed node, or NULL if the deque is empty
+ */
+DOUBLE_SEA_LIB_API void *DSL_DequePop(DSL_Deque *pDeque);
+
+/**
+ * @brief DSL_DequeSteal removes the oldest node from the deque
+ *
+ * Safe to call from any thread. A NULL result means the deque was empty or another
+ * thread won the race for the node, callers usually move on to another victim.
+ *
+ * @param pDeque - A pointer to the deque the node will be stolen from
+ * @return void* - A pointer to the stolen node, or NULL
+ */
+DOUBLE_SEA_LIB_API void *DSL_DequeSteal(DSL_Deque *pDeque);
+
+/**
+ * @brief DSL_DequeSize returns the number of nodes in the deque
+ *
+ * The value is a snapshot and may be stale by the time it is used.
+ *
+ * @param pDeque - A pointer to the deque
+ * @return size_t - The number of nodes in the deque
+ */
+DOUBLE_SEA_LIB_API size_t DSL_DequeSize(DSL_Deque *pDeque);
+
+/**
+ * @brief DSL_DequePushList moves every node of a list into the deque
+ *
+ * Owner thread only. Nodes are pushed head first, so the head is the first to be stolen.
+ * The list must use the same offset as the deque.
+ *
+ * @param pDeque - A pointer to the deque the nodes will be added to
+ * @param pFromList - A pointer to the list the nodes will be taken from
+ * @return size_t - The number of nodes moved
+ */
+DOUBLE_SEA_LIB_API size_t DSL_DequePushList(DSL_Deque *pDeque, DSL_List *pFromList);
+
+#endif // DOUBLE_SEA_DEQUE_H
@@ -0,0 +1,171 @@
+#pragma once
+
+#ifndef DOUBLE_SEA_INLINE_H
+#define DOUBLE_SEA_INLINE_H
+#include "DoubleSeaLib.h"
+
+// __________________________ Macros __________________________
+
+#if defined(_MSC_VER) && !defined(__cplusplus)
+#define DSL_INLINE static __inline
+#else
+#define DSL_INLINE static inline
+#endif
+
+// __________________________ Inline Functions __________________________
+//
+// Header copies of the link accessors and of DSL_Push, DSL_Pop and DSL_RemoveNode, so hot
+// loops in the caller compile down to direct loads and stores instead of calls into the
+// library. Lists with a filter or deferred ordering fall back to the library functions,
+// which keep those modes up to date.
+
+/**
+ * @brief DSL_NextPointer gets the pointer to the pNext field of a node
+ *
+ * @param pNode - A pointer to the node
+ * @param offset - The offset of the pNext field in the node
+ * @return void** - A pointer to the pNext field
+ */
+DSL_INLINE void **DSL_NextPointer(void *pNode, size_t offset)
+{
+	return (void **)((char *)pNode + offset);
+}
+
+/**
+ * @brief DSL_PrevPointer gets the pointer to the pPrev field of a node
+ *
+ * @param pNode - A pointer to the node
+ * @param offset - The offset of the pNext field in the node
+ * @return void** - A pointer to the pPrev field
+ */
+DSL_INLINE void **DSL_PrevPointer(void *pNode, size_t offset)
+{
+	return (void **)((char *)pNode + offset + sizeof(void *));
+}
+
+/**
+ * @brief DSL_DataPointer gets the pointer to the data field of a node
+ *
+ * @param pNode - A pointer to the node
+ * @param offset - The offset of the pNext field in the node
+ * @return void** - A pointer to the data field
+ */
+DSL_INLINE void **DSL_DataPointer(void *pNode, size_t offset)
+{
+	return (void **)((char *)pNode + offset - sizeof(void *));
+}
+
+/**
+ * @brief DSL_IsPlainList checks if a list can be changed without the library functions
+ *
+ * @param pList - A pointer to the list
+ * @return int - 1 if no filter or deferred ordering is active, 0 otherwise
+ */
+DSL_INLINE int DSL_IsPlainList(DSL_List *pList)
+{
+	return !pList->pFilter && !pList->deferredOrder && !pList->pPending;
+}
+
+/**
+ * @brief DSL_PushInline inserts a node at the head of a list, like DSL_Push
+ *
+ * @param pNode - A pointer to the node that will be inserted
+ * @param pIntoList - A pointer to the list that the node will be inserted into
+ */
+DSL_INLINE void DSL_PushInline(void *pNode, DSL_List *pIntoList)
+{
+	if (!pIntoList || !pNode)
+	{
+		return;
+	}
+
+	if (!DSL_IsPlainList(pIntoList))
+	{
+		DSL_Push(pNode, pIntoList);
+		return;
+	}
+
+	if (pIntoList->pHead != pNode)
+	{
+		size_t offset = pIntoList->offset;
+		*DSL_PrevPointer(pNode, offset) = NULL;
+		*DSL_NextPointer(pNode, offset) = pIntoList->length == 0 ? NULL : pIntoList->pHead;
+
+		if (pIntoList->length == 0)
+			pIntoList->pTail = pNode;
+		else
+			*DSL_PrevPointer(pIntoList->pHead, offset) = pNode;
+
+		pIntoList->pHead = pNode;
+	}
+
+	pIntoList->length++;
+}
+
+/**
+ * @brief DSL_RemoveNodeInline unlinks a node from a list, like DSL_RemoveNode
+ *
+ * @param pNode - A pointer to the node that will be removed
+ * @param pFromList - A pointer to the list that the node will be removed from
+ */
+DSL_INLINE void DSL_RemoveNodeInline(void *pNode, DSL_List *pFromList)
+{
+	if (!pFromList || !pNode || pFromList->length == 0)
+	{
+		return;
+	}
+
+	if (!DSL_IsPlainList(pFromList))
+	{
+		DSL_RemoveNode(pNode, pFromList);
+		return;
+	}
+
+	size_t offset = pFromList->offset;
+	void **pNodeNext = DSL_NextPointer(pNode, offset);
+	void **pNodePrev = DSL_PrevPointer(pNode, offset);
+
+	if (*pNodePrev)
+		*DSL_NextPointer(*pNodePrev, offset) = *pNodeNext;
+	else if (pFromList->pHead == pNode)
+		pFromList->pHead = *pNodeNext;
+
+	if (*pNodeNext)
+		*DSL_PrevPointer(*pNodeNext, offset) = *pNodePrev;
+	else if (pFromList->pTail == pNode)
+		pFromList->pTail = *pNodePrev;
+
+	*pNodeNext = NULL;
+	*pNodePrev = NULL;
+
+	if (--pFromList->length == 0)
+	{
+		pFromList->pHead = NULL;
+		pFromList->pTail = NULL;
+	}
+}
+
+/**
+ * @brief DSL_PopInline removes the first node from a list and returns it, like DSL_Pop
+ *
+ * @param pFromList - A pointer to the list from which the node will be removed
+ * @return void* - A pointer to the removed node
+ */
+DSL_INLINE void *DSL_PopInline(DSL_List *pFromList)
+{
+	if (!pFromList || pFromList->length == 0)
+	{
+		return NULL;
+	}
+
+	if (!DSL_IsPlainList(pFromList))
+	{
+		return DSL_Pop(pFromList);
+	}
+
+	void *pNode = pFromList->pHead;
+	DSL_RemoveNodeInline(pNode, pFromList);
+	return pNode;
+}
+
+#endif // DOUBLE_SEA_INLINE_H
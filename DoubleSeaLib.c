@@ -1,11 +1,55 @@
 #include "pch.h"
 #include <malloc.h>
+#include <string.h>
+#include <math.h>
 #include "DoubleSeaLib.h"
+#include "DoubleSeaPlatform.h"
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief DSL_ArenaBlock is the header of one block of a list's arena.
+ *
+ * @param pNext A pointer to the next block of the region.
+ * @param capacity The number of usable bytes after the header.
+ * @param used The number of bytes handed out since the last reset.
+ */
+typedef struct DSL_ArenaBlock
+{
+	struct DSL_ArenaBlock *pNext;
+	size_t capacity;
+	size_t used;
+} DSL_ArenaBlock;
+
+// __________________________ Macros __________________________
+
+#define DSL_ALIGN_UP(size) (((size) + (DSL_ARENA_ALIGNMENT - 1)) & ~(size_t)(DSL_ARENA_ALIGNMENT - 1))
+#define DSL_ARENA_BLOCK_DATA(pBlock) ((char *)(pBlock) + DSL_ALIGN_UP(sizeof(DSL_ArenaBlock)))
 
 // __________________________ Prototypes __________________________
 
 static void _InsertNodeAtHead(void *pNode, DSL_List *pOfList);
 static void _InsertNodeAtTail(void *pNode, DSL_List *pOfList);
+static void _AppendNode(void *pNode, DSL_List *pOfList);
+static void *_SortChain(void *pFirst, DSL_List *pOfList);
+static void *_MergeChains(void *pA, void *pB, DSL_List *pOfList);
+static void _RepairPrevLinks(void *pFrom, DSL_List *pOfList);
+static DSL_ArenaBlock *_CreateArenaBlock(size_t capacity);
+static void _ReleaseArena(DSL_Arena *pArena);
+static int _ArenaOwns(DSL_Arena *pArena, void *pMemory);
+static uint64_t _HashData(void *pData);
+static void _FilterUpdate(DSL_List *pList, void *pNode, int delta);
+static int _FilterMayContain(DSL_List *pList, void *pWithData);
+static void _ReleaseFilter(DSL_Filter *pFilter);
+static void **_FinishFind(DSL_List *pList, void **pFound, size_t depth);
+static void _UnlinkNode(void *pNode, DSL_List *pFromList);
+static void _LinkBefore(void *pNode, void *pBefore, DSL_List *pOfList);
+static int _CanCombine(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard);
+static size_t _FilterAgainst(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard, int discardMatches);
+static size_t _ResolveBatch(size_t *pTable, size_t mask, size_t *pSameData, void **ppWithData, void *pData, void **pLink, void ***pppResults);
+static int _CompactList(DSL_List *pList, size_t nodeSize, RelocateFunction pRelocate, void *pCtx, int isDSLNode);
+static void _DestroyNodeCallback(void *pNode, void *pCtx);
+static uint32_t *_GetSlotGeneration(DSL_SlotMap *pMap, void *pElement);
 
 // __________________________ Functions __________________________
 
@@ -21,6 +65,8 @@ void *DSL_Pop(DSL_List *pFromList)
 		return NULL;
 	}
 
+	DSL_SettleOrder(pFromList);
+
 	void *pNode = pFromList->pHead;
 	DSL_RemoveNode(pNode, pFromList); // remove node adjusts the count
 	return pNode;
@@ -65,6 +111,7 @@ void DSL_Push(void *pNode, DSL_List *pIntoList)
 		return;
 	}
 	_InsertNodeAtHead(pNode, pIntoList);
+	_FilterUpdate(pIntoList, pNode, 1);
 	pIntoList->length++;
 }
 
@@ -85,6 +132,14 @@ void DSL_RemoveNode(void *pNode, DSL_List *pFromList)
 	void **pNodeNext = _GetNextPointer(pNode, pFromList->offset);
 	void **pNodePrev = _GetPrevPointer(pNode, pFromList->offset);
 
+	// The pending segment now starts at the following node, if any
+	if (pFromList->pPending == pNode)
+	{
+		pFromList->pPending = *pNodeNext;
+	}
+
+	_FilterUpdate(pFromList, pNode, -1);
+
 	// If the node is the head of the list
 	if (pFromList->pHead == pNode)
 	{
@@ -160,6 +215,15 @@ void DSL_InsertNode(void *pNode, DSL_List *pIntoList)
 		*pNodeNext = NULL;
 		*pNodePrev = NULL;
 	}
+	// Deferred ordering appends now and sorts on the first ordered read
+	else if (pIntoList->deferredOrder && pIntoList->orderFunction != NULL)
+	{
+		_InsertNodeAtTail(pNode, pIntoList);
+		if (pIntoList->pPending == NULL)
+		{
+			pIntoList->pPending = pNode;
+		}
+	}
 	else // Otherwise, insert the node in the correct position
 	{
 		void *current = pIntoList->pHead;
@@ -213,6 +277,7 @@ void DSL_InsertNode(void *pNode, DSL_List *pIntoList)
 		}
 	}
 
+	_FilterUpdate(pIntoList, pNode, 1);
 	pIntoList->length++;
 }
 
@@ -222,32 +287,59 @@ void DSL_InsertNode(void *pNode, DSL_List *pIntoList)
  * Destroys a list and frees the memory the struct occupies if it is dynamic.
  * Otherwise, the list is reset to default values but it's memory is not freed.
  * Destroying a list, will also destroy all of it's nodes if the cleanNodes flag is set.
+ * Nodes that live in the list's arena are skipped, the arena is released as a whole.
  *
  * @param pList - A pointer to the list that will be destroyed
  * @param cleanNodes - A flag that indicates if the nodes of the list will be destroyed
  */
 void DSL_DestroyList(DSL_List *pList, int cleanNodes)
+{
+	// arena nodes go away with their region, the callback only frees the others
+	DSL_DestroyListEx(pList, cleanNodes == 1 ? _DestroyNodeCallback : NULL, pList ? pList->pArena : NULL);
+}
+
+/**
+ * @brief DSL_DestroyListEx destroys a list with a destructor callback
+ *
+ * Walks the list once using its offset, so it works with any intrusive structure, and
+ * calls the destructor on every node after unlinking it. The list struct is then freed
+ * if it is dynamic or reset to default values otherwise. When pDestructor is NULL the
+ * nodes are not visited and are simply detached from the list. A list's arena is released
+ * after the destructor has run.
+ *
+ * @param pList - A pointer to the list that will be destroyed
+ * @param pDestructor - A function that releases each node, or NULL
+ * @param pCtx - A context pointer that is passed to the destructor
+ */
+void DSL_DestroyListEx(DSL_List *pList, DestructorFunction pDestructor, void *pCtx)
 {
 	if (pList == NULL)
 	{
 		return;
 	}
 
-	DSL_Node *pNode = pList->pHead;
-
-	if (cleanNodes == 1)
+	if (pDestructor != NULL)
 	{
+		void *pNode = pList->pHead;
 		while (pNode != NULL)
 		{
-			// Save the next node
-			DSL_Node *pNext = pNode->pNext;
-			// Destroy the current node
-			DSL_DestroyNode(pNode);
-			// Move to the next node
+			// Save the next node before the destructor releases the current one
+			void **pNodeNext = _GetNextPointer(pNode, pList->offset);
+			void *pNext = *pNodeNext;
+
+			*pNodeNext = NULL;
+			*_GetPrevPointer(pNode, pList->offset) = NULL;
+			pDestructor(pNode, pCtx);
+
 			pNode = pNext;
 		}
 	}
 
+	// the nodes are gone, so is the storage DSL_Compact and the arena gave them
+	free(pList->pBlock);
+	_ReleaseArena(pList->pArena);
+	_ReleaseFilter(pList->pFilter);
+
 	if (pList->dynamic == 1)
 	{
 		free(pList);
@@ -258,6 +350,123 @@ void DSL_DestroyList(DSL_List *pList, int cleanNodes)
 	}
 }
 
+/**
+ * @brief DSL_Compact relocates the nodes of a list into contiguous memory
+ *
+ * Copies every node into a single freshly allocated block in traversal order and rewrites
+ * the links, so walking the list becomes a sequential scan. The block is owned by the list
+ * and released by the next compaction or when the list is destroyed.
+ *
+ * pRelocate is called once per node with its old and new address so external references
+ * can be fixed up. The nodes are copied as opaque bytes and the old nodes are left untouched,
+ * so the caller may reuse or release them, unless they came from an earlier compaction of
+ * this list. Lists of DSL_Node should use DSL_CompactNodes, which frees the dynamic ones.
+ *
+ * Once compacted, a node belongs to the block. A node that is later unlinked, for example by
+ * DSL_RemoveNode or DSL_Pop, still lives in the block and becomes invalid at the next
+ * compaction or when the list is destroyed, so copy it out first if it has to outlive those.
+ *
+ * @param pList - A pointer to the list that will be compacted
+ * @param nodeSize - The size of each node in bytes
+ * @param pRelocate - A function that is told where each node moved, or NULL
+ * @param pCtx - A context pointer that is passed to pRelocate
+ * @return int - 1 on success, 0 if the block could not be allocated and the list is unchanged
+ */
+int DSL_Compact(DSL_List *pList, size_t nodeSize, RelocateFunction pRelocate, void *pCtx)
+{
+	return _CompactList(pList, nodeSize, pRelocate, pCtx, 0);
+}
+
+/**
+ * @brief DSL_CompactNodes relocates the DSL_Node nodes of a list into contiguous memory
+ *
+ * Works like DSL_Compact with a nodeSize of sizeof(DSL_Node), and manages the nodes' dynamic
+ * flags: dynamic originals are freed after pRelocate has been called and the copies are
+ * marked non-dynamic. Non-dynamic originals are left untouched and belong to the caller.
+ *
+ * @param pList - A pointer to a list of DSL_Node that will be compacted
+ * @param pRelocate - A function that is told where each node moved, or NULL
+ * @param pCtx - A context pointer that is passed to pRelocate
+ * @return int - 1 on success, 0 if the list doesn't use OFFSETOF_DSL_NODE or the block could
+ * 				 not be allocated, the list is unchanged then
+ */
+int DSL_CompactNodes(DSL_List *pList, RelocateFunction pRelocate, void *pCtx)
+{
+	if (!pList || pList->offset != OFFSETOF_DSL_NODE)
+	{
+		return 0;
+	}
+
+	return _CompactList(pList, sizeof(DSL_Node), pRelocate, pCtx, 1);
+}
+
+/**
+ * @brief DSL_RemoveIf removes every matching node from a list
+ *
+ * Unlinks all nodes that match the predicate in a single traversal. Removed nodes are
+ * appended to the tail of pOutList in list order when it is provided, the output list
+ * must use the same offset as pFromList.
+ *
+ * @param pFromList - A pointer to the list from which the nodes will be removed
+ * @param pPredicate - A function that returns non-zero for the nodes to remove
+ * @param pCtx - A context pointer that is passed to the predicate
+ * @param pOutList - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes removed
+ */
+size_t DSL_RemoveIf(DSL_List *pFromList, PredicateFunction pPredicate, void *pCtx, DSL_List *pOutList)
+{
+	if (!pFromList || !pPredicate || pFromList == pOutList)
+	{
+		return 0;
+	}
+
+	size_t removed = 0;
+	void *pPrev = NULL;
+	void *pNode = pFromList->pHead;
+
+	while (pNode != NULL)
+	{
+		void **pNodeNext = _GetNextPointer(pNode, pFromList->offset);
+		void *pNext = *pNodeNext;
+
+		if (!pPredicate(pNode, pCtx))
+		{
+			pPrev = pNode;
+			pNode = pNext;
+			continue;
+		}
+
+		// splice the node out, pPrev is the last node that was kept
+		if (pFromList->pPending == pNode)
+			pFromList->pPending = pNext;
+
+		if (pPrev == NULL)
+			pFromList->pHead = pNext;
+		else
+			*_GetNextPointer(pPrev, pFromList->offset) = pNext;
+
+		if (pNext == NULL)
+			pFromList->pTail = pPrev;
+		else
+			*_GetPrevPointer(pNext, pFromList->offset) = pPrev;
+
+		*pNodeNext = NULL;
+		*_GetPrevPointer(pNode, pFromList->offset) = NULL;
+		_FilterUpdate(pFromList, pNode, -1);
+		pFromList->length--;
+		removed++;
+
+		if (pOutList)
+		{
+			_AppendNode(pNode, pOutList);
+		}
+
+		pNode = pNext;
+	}
+
+	return removed;
+}
+
 /**
  * @brief DSL_FindNode finds a node in a list
  *
@@ -269,11 +478,13 @@ void DSL_DestroyList(DSL_List *pList, int cleanNodes)
  */
 void **DSL_FindNode(DSL_List *pList, void *pWithData)
 {
-	if (!pList || !pWithData)
+	if (!pList || !pWithData || pList->length == 0 || !_FilterMayContain(pList, pWithData))
 	{
 		return NULL;
 	}
 
+	DSL_SettleOrder(pList);
+
 	// get the head of the list
 	void **pNode = &pList->pHead;
 
@@ -283,7 +494,7 @@ void **DSL_FindNode(DSL_List *pList, void *pWithData)
 	// check if the data in the head node is the same as the data we are looking for
 	if (pNodeData != NULL && *pNodeData == pWithData)
 	{
-		return &pList->pHead;
+		return _FinishFind(pList, &pList->pHead, 1);
 	}
 
 	// check if the data in the tail node is the same as the data we are looking for
@@ -291,25 +502,225 @@ void **DSL_FindNode(DSL_List *pList, void *pWithData)
 	pNodeData = _GetDataPointer(*pNode, pList->offset);
 	if (pNodeData != NULL && *pNodeData == pWithData)
 	{
-		return &pList->pTail;
+		return _FinishFind(pList, &pList->pTail, 2);
 	}
 
-	// traverse the list looking for the data
-	pNode = &pList->pHead;
-	while (pNode != NULL)
+	// traverse the list looking for the data, stopping at the tail's NULL pNext
+	size_t depth = 2;
+	pNode = _GetNextPointer(pList->pHead, pList->offset);
+	while (*pNode != NULL)
 	{
-		// get the next node
-		pNode = _GetNextPointer(*pNode, pList->offset);
+		depth++;
 		// get the pointer to the data in the node
 		pNodeData = _GetDataPointer(*pNode, pList->offset);
 		// check if the data in the node is the same as the data we are looking for
 		if (pNodeData != NULL && *pNodeData == pWithData)
 		{
-			return pNode;
+			return _FinishFind(pList, pNode, depth);
+		}
+		// get the next node
+		pNode = _GetNextPointer(*pNode, pList->offset);
+	}
+
+	// the filter let this lookup through but the data isn't here
+	if (pList->pFilter)
+	{
+		pList->pFilter->falsePositives++;
+	}
+
+	return _FinishFind(pList, NULL, depth);
+}
+
+/**
+ * @brief DSL_FindNodeBatch finds the nodes for many data pointers in one pass over a list
+ *
+ * Equivalent to calling DSL_FindNode for every entry of ppWithData, but the list is walked
+ * once for the whole batch and each node is checked against all outstanding lookups, so a
+ * list that doesn't fit in cache is only brought in once. The walk stops as soon as every
+ * lookup has been answered. Every lookup is counted in the scan statistics. Self-organizing
+ * lists move nodes on every hit, so their lookups are answered one by one with DSL_FindNode.
+ *
+ * @param pList - A pointer to the list that the nodes will be searched in
+ * @param ppWithData - An array of count pointers to the data to look for
+ * @param count - The number of lookups
+ * @param pppResults - An array of count entries that receives what DSL_FindNode would return
+ * @return size_t - The number of lookups that found a node
+ */
+size_t DSL_FindNodeBatch(DSL_List *pList, void **ppWithData, size_t count, void ***pppResults)
+{
+	if (!ppWithData || !pppResults)
+	{
+		return 0;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		pppResults[i] = NULL;
+	}
+
+	if (!pList || pList->length == 0 || count == 0)
+	{
+		return 0;
+	}
+
+	// open addressing table from data pointer to the first lookup asking for it, lookups
+	// for the same data are chained through pSameData
+	size_t tableSize = 16;
+	while (tableSize < count * 2)
+	{
+		tableSize <<= 1;
+	}
+
+	// a self-organizing list moves each hit, which changes where the next lookup finds its node
+	size_t *pTable = pList->organizePolicy == DSL_ORGANIZE_NONE ? malloc(sizeof(size_t) * (tableSize + count)) : NULL;
+	if (!pTable)
+	{
+		// no room for the table or no fixed order, answer the lookups one by one
+		size_t found = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			pppResults[i] = DSL_FindNode(pList, ppWithData[i]);
+			found += pppResults[i] != NULL;
+		}
+		return found;
+	}
+
+	size_t *pSameData = pTable + tableSize;
+	size_t mask = tableSize - 1;
+	memset(pTable, 0xFF, sizeof(size_t) * tableSize);
+
+	size_t outstanding = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		// lookups the filter rules out never enter the table
+		if (!ppWithData[i] || !_FilterMayContain(pList, ppWithData[i]))
+		{
+			continue;
+		}
+
+		size_t slot = (size_t)_HashData(ppWithData[i]) & mask;
+		while (pTable[slot] != SIZE_MAX && ppWithData[pTable[slot]] != ppWithData[i])
+		{
+			slot = (slot + 1) & mask;
+		}
+
+		pSameData[i] = pTable[slot];
+		pTable[slot] = i;
+		outstanding++;
+	}
+
+	DSL_SettleOrder(pList);
+
+	// same order as DSL_FindNode: the head, then the tail, then the nodes in between
+	size_t found = 0;
+	size_t hits = 0;
+	size_t depth = 2;
+	size_t depthSum = 0;
+	void **pLink = &pList->pHead;
+	hits = _ResolveBatch(pTable, mask, pSameData, ppWithData, *_GetDataPointer(pList->pHead, pList->offset), pLink, pppResults);
+	found += hits;
+	depthSum += hits;
+	pLink = &pList->pTail;
+	hits = _ResolveBatch(pTable, mask, pSameData, ppWithData, *_GetDataPointer(pList->pTail, pList->offset), pLink, pppResults);
+	found += hits;
+	depthSum += hits * 2;
+
+	pLink = _GetNextPointer(pList->pHead, pList->offset);
+	while (found < outstanding && *pLink != NULL)
+	{
+		void *pNode = *pLink;
+		void **pNext = _GetNextPointer(pNode, pList->offset);
+
+		// start fetching the next node before probing the table for this one
+		if (*pNext)
+		{
+			DSL_PREFETCH(*pNext);
 		}
+
+		depth++;
+		hits = _ResolveBatch(pTable, mask, pSameData, ppWithData, *_GetDataPointer(pNode, pList->offset), pLink, pppResults);
+		found += hits;
+		depthSum += hits * depth;
+		pLink = pNext;
+	}
+
+	if (pList->pFilter)
+	{
+		pList->pFilter->falsePositives += outstanding - found;
+	}
+
+	// record the same scan statistics as one DSL_FindNode per lookup, misses walk the whole list
+	pList->findCount += outstanding;
+	pList->findDepth += depthSum + (outstanding - found) * depth;
+
+	free(pTable);
+	return found;
+}
+
+/**
+ * @brief DSL_SetSelfOrganizing picks how an unordered list reorders itself on lookups
+ *
+ * With a policy other than DSL_ORGANIZE_NONE, every node found by DSL_FindNode (and so
+ * DSL_Contains) is moved towards the head, so frequently looked up nodes are found after
+ * fewer hops. DSL_ORGANIZE_COUNT keeps a size_t access counter in each node at countOffset
+ * and keeps the list sorted by it, the counters have to start at 0. Ordered lists keep
+ * their order and can't self-organize.
+ *
+ * @param pList - A pointer to the list
+ * @param policy - One of the DSL_ORGANIZE_* policies
+ * @param countOffset - The offset to the access counter in the node, used by DSL_ORGANIZE_COUNT
+ * @return int - 1 on success, 0 if the list is ordered or the policy is unknown
+ */
+int DSL_SetSelfOrganizing(DSL_List *pList, int policy, size_t countOffset)
+{
+	if (!pList || policy < DSL_ORGANIZE_NONE || policy > DSL_ORGANIZE_COUNT)
+	{
+		return 0;
+	}
+
+	if (pList->orderFunction && policy != DSL_ORGANIZE_NONE)
+	{
+		return 0;
+	}
+
+	pList->organizePolicy = policy;
+	pList->countOffset = countOffset;
+	return 1;
+}
+
+/**
+ * @brief DSL_AverageScanDepth returns the average number of nodes DSL_FindNode compared
+ *
+ * Counts every lookup that reached the list, hits and misses, since the list was
+ * initialized or DSL_ResetScanStats was called.
+ *
+ * @param pList - A pointer to the list
+ * @return double - The average number of nodes compared per lookup, 0 if there were none
+ */
+double DSL_AverageScanDepth(DSL_List *pList)
+{
+	if (!pList || pList->findCount == 0)
+	{
+		return 0.0;
+	}
+
+	return (double)pList->findDepth / (double)pList->findCount;
+}
+
+/**
+ * @brief DSL_ResetScanStats clears the lookup counters of a list
+ *
+ * @param pList - A pointer to the list
+ */
+void DSL_ResetScanStats(DSL_List *pList)
+{
+	if (!pList)
+	{
+		return;
 	}
 
-	return NULL;
+	pList->findCount = 0;
+	pList->findDepth = 0;
 }
 
 /**
@@ -386,130 +797,1476 @@ void DSL_InitList(int isDynamic, size_t offset, DSL_List *pList, OrderFunction p
 	pList->dynamic = isDynamic;
 	pList->orderFunction = pOrderFunction;
 	pList->offset = offset == -1 ? OFFSETOF_DSL_NODE : offset;
+	pList->pBlock = NULL;
+	pList->deferredOrder = 0;
+	pList->pPending = NULL;
+	pList->pArena = NULL;
+	pList->pFilter = NULL;
+	pList->organizePolicy = DSL_ORGANIZE_NONE;
+	pList->countOffset = 0;
+	pList->findCount = 0;
+	pList->findDepth = 0;
 }
 
 /**
- * @brief Gets the pointer to the next node in a doubly linked list.
+ * @brief DSL_EnableArena gives a list its own allocation region
  *
- * This function gets the pointer to the next node in a doubly linked list.
+ * After this, DSL_ArenaAlloc and DSL_ArenaAllocNode bump-allocate from blocks owned by the
+ * list. Destroying or resetting the list releases the whole region in O(blocks). Arena
+ * nodes are never freed one by one, but DSL_DestroyList still frees dynamic nodes that came
+ * from elsewhere. DSL_ResetList doesn't visit nodes, so those have to be removed first.
  *
- * @param pNode Pointer to the current node.
- * @param offset Offset to the pNext field in the data structure.
- * @return Pointer to the next node.
+ * @param pList - A pointer to the list
+ * @param blockSize - The size in bytes of each block the region grows by
+ * @return int - 1 on success, 0 if the region could not be allocated
  */
-void **_GetNextPointer(void *pNode, size_t offset)
+int DSL_EnableArena(DSL_List *pList, size_t blockSize)
 {
-	return (void **)((char *)pNode + offset);
+	if (!pList)
+	{
+		return 0;
+	}
+
+	if (pList->pArena)
+	{
+		return 1;
+	}
+
+	DSL_Arena *pArena = malloc(sizeof(DSL_Arena));
+	if (!pArena)
+	{
+		return 0;
+	}
+
+	// blocks are created lazily by the first allocation
+	pArena->pFirst = NULL;
+	pArena->pCurrent = NULL;
+	pArena->blockSize = blockSize < DSL_ARENA_ALIGNMENT ? DSL_ARENA_ALIGNMENT : blockSize;
+	pArena->blockCount = 0;
+	pList->pArena = pArena;
+	return 1;
 }
 
 /**
- * @brief Gets the pointer to the previous node in a doubly linked list.
+ * @brief DSL_ArenaAlloc allocates memory from a list's arena
  *
- * This function gets the pointer to the previous node in a doubly linked list.
+ * Memory is aligned to DSL_ARENA_ALIGNMENT and lives until the list is reset or destroyed.
+ * Use it for payloads that should share the lifetime of the list's nodes.
  *
- * @param pNode Pointer to the current node.
- * @param offset Offset to the pPrev field in the data structure.
- * @return Pointer to the previous node.
+ * @param pList - A pointer to a list with an arena
+ * @param size - The number of bytes to allocate
+ * @return void* - A pointer to the memory, or NULL if the list has no arena or a block could not be allocated
  */
-void **_GetPrevPointer(void *pNode, size_t offset)
+void *DSL_ArenaAlloc(DSL_List *pList, size_t size)
 {
-	return (void **)((char *)pNode + offset + sizeof(void *));
+	if (!pList || !pList->pArena)
+	{
+		return NULL;
+	}
+
+	DSL_Arena *pArena = pList->pArena;
+	DSL_ArenaBlock *pBlock = pArena->pCurrent;
+	size = DSL_ALIGN_UP(size == 0 ? 1 : size);
+
+	// walk forward through blocks kept by DSL_ResetList before asking the system for more
+	while (pBlock && pBlock->used + size > pBlock->capacity && pBlock->pNext)
+	{
+		pBlock = pBlock->pNext;
+	}
+
+	if (!pBlock || pBlock->used + size > pBlock->capacity)
+	{
+		DSL_ArenaBlock *pNew = _CreateArenaBlock(size > pArena->blockSize ? size : pArena->blockSize);
+		if (!pNew)
+		{
+			return NULL;
+		}
+
+		if (pBlock)
+			pBlock->pNext = pNew;
+		else
+			pArena->pFirst = pNew;
+
+		pArena->blockCount++;
+		pBlock = pNew;
+	}
+
+	pArena->pCurrent = pBlock;
+
+	void *pMemory = DSL_ARENA_BLOCK_DATA(pBlock) + pBlock->used;
+	pBlock->used += size;
+	return pMemory;
 }
 
 /**
- * @brief Gets the pointer to the data in a doubly linked list node.
+ * @brief DSL_ArenaAllocNode allocates and initializes a DSL_Node from a list's arena
  *
- * This function gets the pointer to the data in a doubly linked list node.
+ * The node is not dynamic, so DSL_DestroyNode never frees it on its own.
  *
- * @param pNode Pointer to the current node.
- * @param offset Offset to the pNext field in the data structure.
- * @return Pointer to the data.
+ * @param pList - A pointer to a list with an arena
+ * @param pWithData - A pointer to the data that the node will hold
+ * @return DSL_Node* - A pointer to the node, or NULL if it could not be allocated
  */
-void **_GetDataPointer(void *pNode, size_t offset)
+DSL_Node *DSL_ArenaAllocNode(DSL_List *pList, void *pWithData)
 {
-
-	return (void **)((char *)pNode + offset - sizeof(void *));
+	DSL_Node *pNode = DSL_ArenaAlloc(pList, sizeof(DSL_Node));
+	DSL_InitNode(0, pNode, pWithData);
+	return pNode;
 }
 
-// __________________________ Static Functions __________________________
-
 /**
- * @brief Inserts a node at the head of a doubly linked list.
+ * @brief DSL_ResetList empties a list without visiting its nodes
  *
- * This function inserts a node at the head of a doubly linked list.
+ * The list keeps its offset, order function and modes. If it has an arena, the region is
+ * rewound so its blocks are reused by the next allocations instead of going back to the
+ * system allocator. Nodes that were in the list are simply forgotten.
  *
- * @param pNode Pointer to the node to insert.
- * @param pOfList Pointer to the list to insert the node into.
- * @return Nothing
- * @note This function does not increment the count of the list, it is assumed that the
- *       caller will increment the count if necessary.
+ * @param pList - A pointer to the list that will be reset
  */
-static void _InsertNodeAtHead(void *pNode, DSL_List *pOfList)
+void DSL_ResetList(DSL_List *pList)
 {
-	// validate the input
-	if (!pNode || !pOfList || pOfList->pHead == pNode)
+	if (!pList)
 	{
 		return;
 	}
 
-	// get the next and previous pointers
-	void **pNext = _GetNextPointer(pNode, pOfList->offset);
-	void **pPrev = _GetPrevPointer(pNode, pOfList->offset);
+	pList->pHead = NULL;
+	pList->pTail = NULL;
+	pList->length = 0;
+	pList->pPending = NULL;
 
-	// check if the list is empty
-	if (pOfList->length == 0)
+	if (pList->pArena)
 	{
-		// set the head and tail to the new node
-		pOfList->pHead = pNode;
-		pOfList->pTail = pNode;
-		// set the next and previous pointers to NULL
-		*pNext = NULL;
-		*pPrev = NULL;
+		DSL_ArenaBlock *pBlock = pList->pArena->pFirst;
+		for (; pBlock; pBlock = pBlock->pNext)
+		{
+			pBlock->used = 0;
+		}
+		pList->pArena->pCurrent = pList->pArena->pFirst;
 	}
-	else
+
+	if (pList->pFilter)
 	{
-		// set the next pointer of the new node to the current head
-		*pNext = pOfList->pHead;
-		// set the previous pointer of the current head to the new node
-		*_GetPrevPointer(pOfList->pHead, pOfList->offset) = pNode;
-		// set the head of the list to the new node
-		pOfList->pHead = pNode;
-		// set the previous pointer of the new node to NULL
-		*pPrev = NULL;
+		memset(pList->pFilter->pCounters, 0, pList->pFilter->counterCount);
+	}
+}
+
+/**
+ * @brief DSL_EnableFilter adds a counting Bloom filter to a list
+ *
+ * The filter is sized for expectedItems at the requested false positive rate and is kept
+ * up to date by every insert, push, remove and pop. DSL_FindNode and DSL_Contains use it
+ * to return immediately for data that is definitely not in the list. Nodes already in the
+ * list are added to the new filter, an existing filter is replaced.
+ *
+ * @param pList - A pointer to the list
+ * @param expectedItems - The number of nodes the filter is sized for
+ * @param falsePositiveRate - The target false positive rate, between 0 and 1
+ * @return int - 1 on success, 0 if the filter could not be allocated
+ */
+int DSL_EnableFilter(DSL_List *pList, size_t expectedItems, double falsePositiveRate)
+{
+	if (!pList || falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0)
+	{
+		return 0;
+	}
+
+	if (expectedItems == 0)
+	{
+		expectedItems = 1;
+	}
+
+	// optimal sizes: m = -n ln(p) / ln(2)^2 counters and k = (m / n) ln(2) hashes
+	double ln2 = log(2.0);
+	double bits = -(double)expectedItems * log(falsePositiveRate) / (ln2 * ln2);
+	size_t counterCount = 64;
+	while ((double)counterCount < bits)
+	{
+		counterCount <<= 1;
+	}
+
+	size_t hashCount = (size_t)(((double)counterCount / (double)expectedItems) * ln2 + 0.5);
+	if (hashCount < 1)
+		hashCount = 1;
+	if (hashCount > 16)
+		hashCount = 16;
+
+	DSL_Filter *pFilter = malloc(sizeof(DSL_Filter));
+	uint8_t *pCounters = calloc(counterCount, 1);
+	if (!pFilter || !pCounters)
+	{
+		free(pFilter);
+		free(pCounters);
+		return 0;
+	}
+
+	pFilter->pCounters = pCounters;
+	pFilter->counterCount = counterCount;
+	pFilter->hashCount = hashCount;
+	pFilter->definiteMisses = 0;
+	pFilter->falsePositives = 0;
+
+	_ReleaseFilter(pList->pFilter);
+	pList->pFilter = pFilter;
+	DSL_RebuildFilter(pList);
+	return 1;
+}
+
+/**
+ * @brief DSL_DisableFilter removes the filter from a list
+ *
+ * @param pList - A pointer to the list
+ */
+void DSL_DisableFilter(DSL_List *pList)
+{
+	if (!pList)
+	{
+		return;
+	}
+
+	_ReleaseFilter(pList->pFilter);
+	pList->pFilter = NULL;
+}
+
+/**
+ * @brief DSL_RebuildFilter recomputes a list's filter from its nodes
+ *
+ * Needed after nodes were linked into the list by hand, and clears counters that saturated.
+ *
+ * @param pList - A pointer to the list
+ */
+void DSL_RebuildFilter(DSL_List *pList)
+{
+	if (!pList || !pList->pFilter)
+	{
+		return;
+	}
+
+	memset(pList->pFilter->pCounters, 0, pList->pFilter->counterCount);
+	for (void *pNode = pList->pHead; pNode; pNode = *_GetNextPointer(pNode, pList->offset))
+	{
+		_FilterUpdate(pList, pNode, 1);
+	}
+}
+
+/**
+ * @brief DSL_GetFilterStats reports the memory use and accuracy of a list's filter
+ *
+ * @param pList - A pointer to the list
+ * @param pStats - A pointer to the structure that receives the statistics
+ * @return int - 1 if the list has a filter, 0 otherwise
+ */
+int DSL_GetFilterStats(DSL_List *pList, DSL_FilterStats *pStats)
+{
+	if (!pList || !pList->pFilter || !pStats)
+	{
+		return 0;
+	}
+
+	DSL_Filter *pFilter = pList->pFilter;
+	double k = (double)pFilter->hashCount;
+
+	pStats->memoryBytes = sizeof(DSL_Filter) + pFilter->counterCount;
+	pStats->counterCount = pFilter->counterCount;
+	pStats->hashCount = pFilter->hashCount;
+	// (1 - e^(-kn/m))^k
+	pStats->estimatedFalsePositiveRate = pow(1.0 - exp(-k * (double)pList->length / (double)pFilter->counterCount), k);
+	pStats->definiteMisses = pFilter->definiteMisses;
+	pStats->falsePositives = pFilter->falsePositives;
+	return 1;
+}
+
+/**
+ * @brief DSL_Contains checks if a list holds a node with the given data
+ *
+ * Returns immediately when the list's filter rules the data out, otherwise falls back
+ * to DSL_FindNode, so the answer is always exact.
+ *
+ * @param pList - A pointer to the list that will be searched
+ * @param pWithData - A pointer to the data to look for
+ * @return int - 1 if a node holds the data, 0 otherwise
+ */
+int DSL_Contains(DSL_List *pList, void *pWithData)
+{
+	return DSL_FindNode(pList, pWithData) != NULL;
+}
+
+/**
+ * @brief DSL_SetDeferredOrder turns deferred ordering on or off for a list
+ *
+ * While deferred ordering is on, DSL_InsertNode appends to an unsorted pending segment
+ * at the tail in O(1) instead of scanning for the node's position. The first operation
+ * that needs order (DSL_Pop, DSL_FindNode, DSL_SettleOrder) sorts the pending segment and
+ * merges it into the ordered part. Turning it off settles the list immediately.
+ *
+ * @param pList - A pointer to the list
+ * @param enable - 1 to defer ordering, 0 to order on every insert
+ */
+void DSL_SetDeferredOrder(DSL_List *pList, int enable)
+{
+	if (!pList)
+	{
+		return;
+	}
+
+	if (!enable)
+	{
+		DSL_SettleOrder(pList);
+	}
+
+	pList->deferredOrder = enable ? 1 : 0;
+}
+
+/**
+ * @brief DSL_SettleOrder puts any pending nodes of a list in order
+ *
+ * Sorts the pending segment with a stable merge sort and merges it into the ordered part
+ * of the list, so nodes with equal keys keep their insertion order. Call this before
+ * walking pHead/pNext directly on a list with deferred ordering.
+ *
+ * @param pList - A pointer to the list that will be settled
+ */
+void DSL_SettleOrder(DSL_List *pList)
+{
+	if (!pList || !pList->pPending)
+	{
+		return;
+	}
+
+	void *pPending = pList->pPending;
+	pList->pPending = NULL;
+
+	if (!pList->orderFunction)
+	{
+		return;
+	}
+
+	// split the ordered prefix from the pending tail segment
+	void *pPrefixTail = *_GetPrevPointer(pPending, pList->offset);
+	if (pPrefixTail)
+	{
+		*_GetNextPointer(pPrefixTail, pList->offset) = NULL;
+	}
+
+	void *pSorted = _SortChain(pPending, pList);
+
+	if (pPrefixTail == NULL)
+	{
+		// everything was pending
+		pList->pHead = pSorted;
+		*_GetPrevPointer(pSorted, pList->offset) = NULL;
+		_RepairPrevLinks(pSorted, pList);
+	}
+	else if (pList->orderFunction(pSorted, pPrefixTail) >= 0)
+	{
+		// the whole batch belongs after the prefix, only the batch needs relinking
+		*_GetNextPointer(pPrefixTail, pList->offset) = pSorted;
+		_RepairPrevLinks(pPrefixTail, pList);
+	}
+	else
+	{
+		pList->pHead = _MergeChains(pList->pHead, pSorted, pList);
+		*_GetPrevPointer(pList->pHead, pList->offset) = NULL;
+		_RepairPrevLinks(pList->pHead, pList);
+	}
+}
+
+/**
+ * @brief DSL_MergeK merges k ordered lists into one list in a single pass
+ *
+ * Relinks the nodes of every source list, and any nodes already in pIntoList, into one
+ * ordered list in pIntoList. The lists are merged pairwise in rounds, so every node takes
+ * part in log2(k) merges and the cost is O(n log k) without allocating. Equal nodes keep
+ * the order of their lists, with pIntoList's own nodes first. pIntoList's order function is
+ * used, or the sources' if it has none. The source lists must be distinct, must not include
+ * pIntoList, and must share its offset and that order function, otherwise nothing is moved.
+ * The source lists are left empty.
+ *
+ * @param ppLists - An array of k pointers to the ordered lists that will be merged
+ * @param k - The number of source lists
+ * @param pIntoList - A pointer to the list that receives the nodes
+ * @return size_t - The number of nodes moved from the source lists
+ */
+size_t DSL_MergeK(DSL_List **ppLists, size_t k, DSL_List *pIntoList)
+{
+	if (!ppLists || !pIntoList)
+	{
+		return 0;
+	}
+
+	for (size_t i = 0; i < k; i++)
+	{
+		if (!ppLists[i] || ppLists[i] == pIntoList || ppLists[i]->offset != pIntoList->offset)
+		{
+			return 0;
+		}
+
+		// a list that appears twice would be merged into itself
+		for (size_t j = 0; j < i; j++)
+		{
+			if (ppLists[j] == ppLists[i])
+				return 0;
+		}
+	}
+
+	DSL_List *pOrderList = pIntoList->orderFunction || k == 0 ? pIntoList : ppLists[0];
+	if (!pOrderList->orderFunction)
+	{
+		return 0;
+	}
+
+	// the chains are only merged correctly if every source is sorted by the same order
+	for (size_t i = 0; i < k; i++)
+	{
+		if (ppLists[i]->orderFunction != pOrderList->orderFunction)
+			return 0;
+	}
+
+	// every chain has to be in order before it is merged
+	size_t moved = 0;
+	DSL_SettleOrder(pIntoList);
+	for (size_t i = 0; i < k; i++)
+	{
+		DSL_SettleOrder(ppLists[i]);
+		moved += ppLists[i]->length;
+	}
+
+	if (moved == 0)
+	{
+		return 0;
+	}
+
+	// the pHead fields hold the intermediate chains, list i absorbs list i + step each round
+	for (size_t step = 1; step < k; step *= 2)
+	{
+		for (size_t i = 0; i + step < k; i += 2 * step)
+		{
+			ppLists[i]->pHead = _MergeChains(ppLists[i]->pHead, ppLists[i + step]->pHead, pOrderList);
+			ppLists[i + step]->pHead = NULL;
+		}
+	}
+
+	pIntoList->pHead = _MergeChains(pIntoList->pHead, ppLists[0]->pHead, pOrderList);
+	*_GetPrevPointer(pIntoList->pHead, pIntoList->offset) = NULL;
+	_RepairPrevLinks(pIntoList->pHead, pIntoList);
+	pIntoList->length += moved;
+	DSL_RebuildFilter(pIntoList);
+
+	for (size_t i = 0; i < k; i++)
+	{
+		ppLists[i]->pHead = NULL;
+		ppLists[i]->pTail = NULL;
+		ppLists[i]->length = 0;
+		DSL_RebuildFilter(ppLists[i]);
+	}
+
+	return moved;
+}
+
+/**
+ * @brief DSL_Union moves the nodes of one ordered list into another, skipping duplicates
+ *
+ * Walks both lists once and relinks every node of pB into its place in pA, unless pA
+ * already holds an equal node. Those duplicates are appended to pDiscard, or just unlinked
+ * when it is NULL. pB is left empty. Both lists must be ordered by pA's order function and
+ * share an offset. Equal nodes within pA are kept, see DSL_Dedup.
+ *
+ * @param pA - A pointer to the list that receives the union
+ * @param pB - A pointer to the list whose nodes are moved
+ * @param pDiscard - A pointer to the list that receives the duplicates, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+size_t DSL_Union(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard)
+{
+	if (!_CanCombine(pA, pB, pDiscard))
+	{
+		return 0;
+	}
+
+	size_t discarded = 0;
+	void *pNodeA = pA->pHead;
+	void *pNodeB = pB->pHead;
+
+	while (pNodeB)
+	{
+		void *pNextB = *_GetNextPointer(pNodeB, pB->offset);
+		int order = pNodeA ? pA->orderFunction(pNodeA, pNodeB) : 1;
+
+		if (order < 0)
+		{
+			pNodeA = *_GetNextPointer(pNodeA, pA->offset);
+			continue;
+		}
+
+		DSL_RemoveNode(pNodeB, pB);
+		if (order == 0)
+		{
+			// pA already holds it, pNodeA stays put in case pB has more copies
+			if (pDiscard)
+				_AppendNode(pNodeB, pDiscard);
+			discarded++;
+		}
+		else if (pNodeA)
+		{
+			_LinkBefore(pNodeB, pNodeA, pA);
+			_FilterUpdate(pA, pNodeB, 1);
+			pA->length++;
+		}
+		else
+		{
+			// everything left in pB comes after pA's tail
+			_AppendNode(pNodeB, pA);
+		}
+		pNodeB = pNextB;
+	}
+
+	return discarded;
+}
+
+/**
+ * @brief DSL_Intersect keeps only the nodes of an ordered list that another list also holds
+ *
+ * Walks both lists once and unlinks every node of pA without an equal node in pB. Those
+ * nodes are appended to pDiscard, or just unlinked when it is NULL. pB is not changed.
+ * Both lists must be ordered by pA's order function and share an offset.
+ *
+ * @param pA - A pointer to the list that is reduced to the intersection
+ * @param pB - A pointer to the list that is intersected with
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+size_t DSL_Intersect(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard)
+{
+	return _CanCombine(pA, pB, pDiscard) ? _FilterAgainst(pA, pB, pDiscard, 0) : 0;
+}
+
+/**
+ * @brief DSL_Difference removes the nodes of an ordered list that another list also holds
+ *
+ * Walks both lists once and unlinks every node of pA with an equal node in pB. Those nodes
+ * are appended to pDiscard, or just unlinked when it is NULL. pB is not changed. Both
+ * lists must be ordered by pA's order function and share an offset.
+ *
+ * @param pA - A pointer to the list that is reduced to the difference
+ * @param pB - A pointer to the list whose nodes are subtracted
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+size_t DSL_Difference(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard)
+{
+	return _CanCombine(pA, pB, pDiscard) ? _FilterAgainst(pA, pB, pDiscard, 1) : 0;
+}
+
+/**
+ * @brief DSL_Dedup removes all but the first of every run of equal nodes in an ordered list
+ *
+ * The removed nodes are appended to pDiscard, or just unlinked when it is NULL.
+ *
+ * @param pList - A pointer to the ordered list
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+size_t DSL_Dedup(DSL_List *pList, DSL_List *pDiscard)
+{
+	if (!pList || !pList->orderFunction || pDiscard == pList)
+	{
+		return 0;
+	}
+
+	DSL_SettleOrder(pList);
+
+	size_t discarded = 0;
+	void *pKeep = pList->pHead;
+	while (pKeep)
+	{
+		void *pNode = *_GetNextPointer(pKeep, pList->offset);
+		if (pNode && pList->orderFunction(pKeep, pNode) == 0)
+		{
+			DSL_RemoveNode(pNode, pList);
+			if (pDiscard)
+				_AppendNode(pNode, pDiscard);
+			discarded++;
+		}
+		else
+		{
+			pKeep = pNode;
+		}
+	}
+
+	return discarded;
+}
+
+/**
+ * @brief DSL_InitSlotMap initializes a slot map over a static storage array
+ *
+ * Writes each element's index at `pArgs->indexOffset`, resets its generation and threads
+ * every element onto the slot map's free list. Generations are odd while an element is
+ * allocated and even while it is free, so a handle is only ever valid for the allocation
+ * that produced it. Nothing is initialized if `pArgs->maxItems` exceeds DSL_HANDLE_MAX_INDEX + 1.
+ *
+ * @param pArgs - A pointer to the arguments that will be used to initialize the slot map
+ */
+void DSL_InitSlotMap(DSL_InitSlotMapArgs *pArgs)
+{
+	if (!pArgs || !pArgs->pMap || (pArgs->maxItems != 0 && pArgs->maxItems - 1 > DSL_HANDLE_MAX_INDEX))
+	{
+		return;
+	}
+
+	DSL_SlotMap *pMap = pArgs->pMap;
+	pMap->data = pArgs->data;
+	pMap->maxItems = pArgs->maxItems;
+	pMap->structSize = pArgs->structSize;
+	pMap->indexOffset = pArgs->indexOffset;
+	pMap->generationOffset = pArgs->generationOffset;
+
+	DSL_InitList(0, pArgs->offset, &pMap->freeList, NULL);
+
+	/* thread the array onto the free list, this also writes each index */
+	DSL_InitStaticStorageListArgs listArgs = {
+		pArgs->data,
+		pArgs->offset,
+		pArgs->maxItems,
+		&pMap->freeList,
+		pArgs->structSize,
+		pArgs->indexOffset,
+		NULL};
+	DSL_InitStaticStorageListWData(&listArgs);
+
+	/* every slot starts out free */
+	for (size_t i = 0; i < pArgs->maxItems; i++)
+	{
+		*_GetSlotGeneration(pMap, (char *)pArgs->data + (i * pArgs->structSize)) = 0;
+	}
+}
+
+/**
+ * @brief DSL_SlotMapAlloc allocates an element from a slot map
+ *
+ * Takes the first element off the free list in O(1) and starts a new generation for it.
+ * The element's links are free for the caller to use while it is allocated.
+ *
+ * @param pMap - A pointer to the slot map to allocate from
+ * @param pOutHandle - A pointer that receives the handle of the element, or DSL_INVALID_HANDLE
+ * @return void* - A pointer to the allocated element, or NULL if the slot map is full
+ */
+void *DSL_SlotMapAlloc(DSL_SlotMap *pMap, DSL_Handle *pOutHandle)
+{
+	if (pOutHandle)
+	{
+		*pOutHandle = DSL_INVALID_HANDLE;
+	}
+
+	if (!pMap)
+	{
+		return NULL;
+	}
+
+	void *pElement = DSL_Pop(&pMap->freeList);
+	if (!pElement)
+	{
+		return NULL;
+	}
+
+	// an even generation means free, bumping it makes the slot live
+	uint32_t *pGeneration = _GetSlotGeneration(pMap, pElement);
+	(*pGeneration)++;
+
+	if (pOutHandle)
+	{
+		*pOutHandle = DSL_SlotMapHandleOf(pMap, pElement);
+	}
+
+	return pElement;
+}
+
+/**
+ * @brief DSL_SlotMapFree returns an element to a slot map
+ *
+ * Ends the element's generation, so every outstanding handle to it becomes stale, and
+ * pushes it onto the free list in O(1). The element must not be linked into another list
+ * through the slot map's links when it is freed.
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param handle - The handle of the element that will be freed
+ * @return int - 1 if the element was freed, 0 if the handle was stale or invalid
+ */
+int DSL_SlotMapFree(DSL_SlotMap *pMap, DSL_Handle handle)
+{
+	void *pElement = DSL_SlotMapGet(pMap, handle);
+	if (!pElement)
+	{
+		return 0;
+	}
+
+	// back to an even generation, every handle to this allocation is now stale
+	(*_GetSlotGeneration(pMap, pElement))++;
+	DSL_Push(pElement, &pMap->freeList);
+	return 1;
+}
+
+/**
+ * @brief DSL_SlotMapGet resolves a handle to its element
+ *
+ * Resolves the handle in O(1) by indexing the backing array and comparing generations.
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param handle - The handle that will be resolved
+ * @return void* - A pointer to the element, or NULL if the handle is stale or invalid
+ */
+void *DSL_SlotMapGet(DSL_SlotMap *pMap, DSL_Handle handle)
+{
+	size_t index = DSL_HANDLE_INDEX(handle);
+	uint32_t generation = DSL_HANDLE_GENERATION(handle);
+
+	// free slots have even generations, so those handles can never resolve
+	if (!pMap || index >= pMap->maxItems || (generation & 1) == 0)
+	{
+		return NULL;
+	}
+
+	void *pElement = (char *)pMap->data + (index * pMap->structSize);
+	if (*_GetSlotGeneration(pMap, pElement) != generation)
+	{
+		return NULL;
+	}
+
+	return pElement;
+}
+
+/**
+ * @brief DSL_SlotMapHandleOf gets the handle of an allocated element
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param pElement - A pointer to the element in the backing array
+ * @return DSL_Handle - The handle of the element, or DSL_INVALID_HANDLE if it is not allocated
+ */
+DSL_Handle DSL_SlotMapHandleOf(DSL_SlotMap *pMap, void *pElement)
+{
+	if (!pMap || !pElement)
+	{
+		return DSL_INVALID_HANDLE;
+	}
+
+	uint32_t generation = *_GetSlotGeneration(pMap, pElement);
+	if ((generation & 1) == 0)
+	{
+		return DSL_INVALID_HANDLE;
+	}
+
+	size_t index = *(size_t *)((char *)pElement + pMap->indexOffset);
+	return ((DSL_Handle)generation << 32) | (DSL_Handle)index;
+}
+
+/**
+ * @brief Gets the pointer to the next node in a doubly linked list.
+ *
+ * This function gets the pointer to the next node in a doubly linked list.
+ *
+ * @param pNode Pointer to the current node.
+ * @param offset Offset to the pNext field in the data structure.
+ * @return Pointer to the next node.
+ */
+void **_GetNextPointer(void *pNode, size_t offset)
+{
+	return (void **)((char *)pNode + offset);
+}
+
+/**
+ * @brief Gets the pointer to the previous node in a doubly linked list.
+ *
+ * This function gets the pointer to the previous node in a doubly linked list.
+ *
+ * @param pNode Pointer to the current node.
+ * @param offset Offset to the pPrev field in the data structure.
+ * @return Pointer to the previous node.
+ */
+void **_GetPrevPointer(void *pNode, size_t offset)
+{
+	return (void **)((char *)pNode + offset + sizeof(void *));
+}
+
+/**
+ * @brief Gets the pointer to the data in a doubly linked list node.
+ *
+ * This function gets the pointer to the data in a doubly linked list node.
+ *
+ * @param pNode Pointer to the current node.
+ * @param offset Offset to the pNext field in the data structure.
+ * @return Pointer to the data.
+ */
+void **_GetDataPointer(void *pNode, size_t offset)
+{
+
+	return (void **)((char *)pNode + offset - sizeof(void *));
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Inserts a node at the head of a doubly linked list.
+ *
+ * This function inserts a node at the head of a doubly linked list.
+ *
+ * @param pNode Pointer to the node to insert.
+ * @param pOfList Pointer to the list to insert the node into.
+ * @return Nothing
+ * @note This function does not increment the count of the list, it is assumed that the
+ *       caller will increment the count if necessary.
+ */
+static void _InsertNodeAtHead(void *pNode, DSL_List *pOfList)
+{
+	// validate the input
+	if (!pNode || !pOfList || pOfList->pHead == pNode)
+	{
+		return;
+	}
+
+	// get the next and previous pointers
+	void **pNext = _GetNextPointer(pNode, pOfList->offset);
+	void **pPrev = _GetPrevPointer(pNode, pOfList->offset);
+
+	// check if the list is empty
+	if (pOfList->length == 0)
+	{
+		// set the head and tail to the new node
+		pOfList->pHead = pNode;
+		pOfList->pTail = pNode;
+		// set the next and previous pointers to NULL
+		*pNext = NULL;
+		*pPrev = NULL;
+	}
+	else
+	{
+		// set the next pointer of the new node to the current head
+		*pNext = pOfList->pHead;
+		// set the previous pointer of the current head to the new node
+		*_GetPrevPointer(pOfList->pHead, pOfList->offset) = pNode;
+		// set the head of the list to the new node
+		pOfList->pHead = pNode;
+		// set the previous pointer of the new node to NULL
+		*pPrev = NULL;
 	}
 }
 
 /**
  * @brief Inserts a node at the tail of a doubly linked list.
  *
- * This function inserts a node at the tail of a doubly linked list.
+ * This function inserts a node at the tail of a doubly linked list.
+ *
+ * @param pNode Pointer to the node to insert.
+ * @param pOfList Pointer to the list to insert the node into.
+ * @return Nothing
+ * @note This function does not increment the count of the list, it is assumed
+ *        that the caller will increment the count if necessary.
+ */
+static void _InsertNodeAtTail(void *pNode, DSL_List *pOfList)
+{
+	// validate the input
+	if (!pNode || !pOfList || pOfList->pTail == pNode)
+	{
+		return;
+	}
+
+	// get the next and previous pointers of the new node
+	void **pNext = _GetNextPointer(pNode, pOfList->offset);
+	void **pPrev = _GetPrevPointer(pNode, pOfList->offset);
+	// get the next pointer of the current tail
+	void **pTailNext = _GetNextPointer(pOfList->pTail, pOfList->offset);
+
+	// set the next pointer of the current tail to the new node
+	*pTailNext = pNode;
+	// set the previous pointer of the new node to the current tail
+	*pPrev = pOfList->pTail;
+	// set the tail of the list to the new node
+	pOfList->pTail = pNode;
+	// set the next pointer of the new node to NULL
+	*pNext = NULL;
+}
+
+/**
+ * @brief Sorts a NULL terminated chain of nodes with a stable bottom-up merge sort.
+ *
+ * Only the pNext links are maintained, the caller repairs pPrev afterwards.
+ *
+ * @param pFirst Pointer to the first node of the chain.
+ * @param pOfList Pointer to the list that provides the offset and order function.
+ * @return Pointer to the first node of the sorted chain.
+ */
+static void *_SortChain(void *pFirst, DSL_List *pOfList)
+{
+	// bins[i] holds a sorted run of 2^i nodes, older nodes live in higher bins
+	void *bins[sizeof(size_t) * 8] = {0};
+	size_t maxBin = 0;
+
+	while (pFirst)
+	{
+		void *pCarry = pFirst;
+		pFirst = *_GetNextPointer(pFirst, pOfList->offset);
+		*_GetNextPointer(pCarry, pOfList->offset) = NULL;
+
+		size_t i = 0;
+		for (; bins[i] != NULL; i++)
+		{
+			pCarry = _MergeChains(bins[i], pCarry, pOfList);
+			bins[i] = NULL;
+		}
+		bins[i] = pCarry;
+		if (i > maxBin)
+			maxBin = i;
+	}
+
+	void *pSorted = NULL;
+	for (size_t i = 0; i <= maxBin; i++)
+	{
+		if (bins[i])
+			pSorted = _MergeChains(bins[i], pSorted, pOfList);
+	}
+
+	return pSorted;
+}
+
+/**
+ * @brief Merges two sorted NULL terminated chains, ties are taken from the first chain.
+ *
+ * Only the pNext links are maintained, the caller repairs pPrev afterwards.
+ *
+ * @param pA Pointer to the first node of the earlier chain.
+ * @param pB Pointer to the first node of the later chain.
+ * @param pOfList Pointer to the list that provides the offset and order function.
+ * @return Pointer to the first node of the merged chain.
+ */
+static void *_MergeChains(void *pA, void *pB, DSL_List *pOfList)
+{
+	void *pHead = NULL;
+	void **ppLink = &pHead;
+
+	while (pA && pB)
+	{
+		void **ppTake = pOfList->orderFunction(pB, pA) < 0 ? &pB : &pA;
+		*ppLink = *ppTake;
+		ppLink = _GetNextPointer(*ppTake, pOfList->offset);
+		*ppTake = *ppLink;
+	}
+
+	*ppLink = pA ? pA : pB;
+	return pHead;
+}
+
+/**
+ * @brief Rewrites the pPrev links after a node and updates the tail of the list.
+ *
+ * @param pFrom Pointer to a node whose own pPrev link is already correct.
+ * @param pOfList Pointer to the list.
+ */
+static void _RepairPrevLinks(void *pFrom, DSL_List *pOfList)
+{
+	void *pNode = pFrom;
+	void *pNext = *_GetNextPointer(pNode, pOfList->offset);
+
+	while (pNext)
+	{
+		*_GetPrevPointer(pNext, pOfList->offset) = pNode;
+		pNode = pNext;
+		pNext = *_GetNextPointer(pNode, pOfList->offset);
+	}
+
+	pOfList->pTail = pNode;
+}
+
+/**
+ * @brief Allocates an empty arena block.
  *
- * @param pNode Pointer to the node to insert.
- * @param pOfList Pointer to the list to insert the node into.
- * @return Nothing
- * @note This function does not increment the count of the list, it is assumed
- *        that the caller will increment the count if necessary.
+ * @param capacity The number of usable bytes in the block.
+ * @return Pointer to the block, or NULL if the allocation failed.
  */
-static void _InsertNodeAtTail(void *pNode, DSL_List *pOfList)
+static DSL_ArenaBlock *_CreateArenaBlock(size_t capacity)
 {
-	// validate the input
-	if (!pNode || !pOfList || pOfList->pTail == pNode)
+	DSL_ArenaBlock *pBlock = malloc(DSL_ALIGN_UP(sizeof(DSL_ArenaBlock)) + capacity);
+	if (!pBlock)
+	{
+		return NULL;
+	}
+
+	pBlock->pNext = NULL;
+	pBlock->capacity = capacity;
+	pBlock->used = 0;
+	return pBlock;
+}
+
+/**
+ * @brief Frees every block of an arena and the arena itself.
+ *
+ * @param pArena Pointer to the arena, may be NULL.
+ */
+static void _ReleaseArena(DSL_Arena *pArena)
+{
+	if (!pArena)
 	{
 		return;
 	}
 
-	// get the next and previous pointers of the new node
-	void **pNext = _GetNextPointer(pNode, pOfList->offset);
-	void **pPrev = _GetPrevPointer(pNode, pOfList->offset);
-	// get the next pointer of the current tail
-	void **pTailNext = _GetNextPointer(pOfList->pTail, pOfList->offset);
+	DSL_ArenaBlock *pBlock = pArena->pFirst;
+	while (pBlock)
+	{
+		DSL_ArenaBlock *pNext = pBlock->pNext;
+		free(pBlock);
+		pBlock = pNext;
+	}
+
+	free(pArena);
+}
+
+/**
+ * @brief Checks whether memory was handed out by an arena.
+ *
+ * @param pArena Pointer to the arena, may be NULL.
+ * @param pMemory Pointer to the memory.
+ * @return 1 if pMemory lies inside one of the arena's blocks, 0 otherwise.
+ */
+static int _ArenaOwns(DSL_Arena *pArena, void *pMemory)
+{
+	if (!pArena)
+	{
+		return 0;
+	}
+
+	uintptr_t address = (uintptr_t)pMemory;
+	for (DSL_ArenaBlock *pBlock = pArena->pFirst; pBlock; pBlock = pBlock->pNext)
+	{
+		uintptr_t start = (uintptr_t)DSL_ARENA_BLOCK_DATA(pBlock);
+		if (address >= start && address < start + pBlock->capacity)
+			return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Hashes a data pointer for the filter.
+ *
+ * @param pData The data pointer.
+ * @return A 64 bit hash, the halves are used as the two hashes of double hashing.
+ */
+static uint64_t _HashData(void *pData)
+{
+	// splitmix64 finalizer, pointers are mostly aligned so the low bits need mixing
+	uint64_t hash = (uint64_t)(uintptr_t)pData;
+	hash ^= hash >> 30;
+	hash *= 0xBF58476D1CE4E5B9ull;
+	hash ^= hash >> 27;
+	hash *= 0x94D049BB133111EBull;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+/**
+ * @brief Adds or removes a node's data pointer from the list's filter.
+ *
+ * @param pList Pointer to the list, nothing happens if it has no filter.
+ * @param pNode Pointer to the node.
+ * @param delta 1 to add the node, -1 to remove it.
+ */
+static void _FilterUpdate(DSL_List *pList, void *pNode, int delta)
+{
+	DSL_Filter *pFilter = pList->pFilter;
+	if (!pFilter)
+	{
+		return;
+	}
+
+	uint64_t hash = _HashData(*_GetDataPointer(pNode, pList->offset));
+	size_t h1 = (size_t)hash;
+	size_t h2 = (size_t)(hash >> 32) | 1;
+	size_t mask = pFilter->counterCount - 1;
+
+	for (size_t i = 0; i < pFilter->hashCount; i++)
+	{
+		uint8_t *pCounter = &pFilter->pCounters[(h1 + (i * h2)) & mask];
+
+		// a saturated counter no longer knows how many items it stands for, so it stays put
+		if (*pCounter == UINT8_MAX)
+			continue;
+
+		if (delta > 0)
+			(*pCounter)++;
+		else if (*pCounter > 0)
+			(*pCounter)--;
+	}
+}
+
+/**
+ * @brief Checks the list's filter for a data pointer.
+ *
+ * @param pList Pointer to the list.
+ * @param pWithData The data pointer to look for.
+ * @return 0 if the data is definitely not in the list, 1 if it may be or there is no filter.
+ */
+static int _FilterMayContain(DSL_List *pList, void *pWithData)
+{
+	DSL_Filter *pFilter = pList->pFilter;
+	if (!pFilter)
+	{
+		return 1;
+	}
+
+	uint64_t hash = _HashData(pWithData);
+	size_t h1 = (size_t)hash;
+	size_t h2 = (size_t)(hash >> 32) | 1;
+	size_t mask = pFilter->counterCount - 1;
+
+	for (size_t i = 0; i < pFilter->hashCount; i++)
+	{
+		if (pFilter->pCounters[(h1 + (i * h2)) & mask] == 0)
+		{
+			pFilter->definiteMisses++;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Answers every lookup of a batch that is waiting for a data pointer.
+ *
+ * @param pTable The batch's open addressing table.
+ * @param mask The table size minus one.
+ * @param pSameData The chains of lookups for the same data.
+ * @param ppWithData The data pointers of the batch.
+ * @param pData The data pointer of the node being visited.
+ * @param pLink The link that holds the node being visited.
+ * @param pppResults The results of the batch.
+ * @return The number of lookups answered, lookups already answered by an earlier node are skipped.
+ */
+static size_t _ResolveBatch(size_t *pTable, size_t mask, size_t *pSameData, void **ppWithData, void *pData, void **pLink, void ***pppResults)
+{
+	if (!pData)
+	{
+		return 0;
+	}
+
+	size_t slot = (size_t)_HashData(pData) & mask;
+	while (pTable[slot] != SIZE_MAX)
+	{
+		size_t lookup = pTable[slot];
+		if (ppWithData[lookup] == pData)
+		{
+			if (pppResults[lookup] != NULL)
+			{
+				return 0;
+			}
+
+			size_t answered = 0;
+			for (; lookup != SIZE_MAX; lookup = pSameData[lookup])
+			{
+				pppResults[lookup] = pLink;
+				answered++;
+			}
+			return answered;
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Records a lookup and moves the found node forward on self-organizing lists.
+ *
+ * @param pList Pointer to the list that was searched.
+ * @param pFound The link holding the found node, or NULL on a miss.
+ * @param depth The number of nodes the lookup compared.
+ * @return The link holding the found node after it has moved, or NULL on a miss.
+ */
+static void **_FinishFind(DSL_List *pList, void **pFound, size_t depth)
+{
+	pList->findCount++;
+	pList->findDepth += depth;
+
+	if (!pFound || pList->organizePolicy == DSL_ORGANIZE_NONE || pList->orderFunction)
+	{
+		return pFound;
+	}
+
+	void *pNode = *pFound;
+	void *pPrev = *_GetPrevPointer(pNode, pList->offset);
+	void *pBefore = NULL;
+
+	if (pList->organizePolicy == DSL_ORGANIZE_MOVE_TO_FRONT)
+	{
+		pBefore = pPrev ? pList->pHead : NULL;
+	}
+	else if (pList->organizePolicy == DSL_ORGANIZE_TRANSPOSE)
+	{
+		pBefore = pPrev;
+	}
+	else
+	{
+		// step over every node that has been found fewer times, equal counts keep their order
+		size_t count = ++*(size_t *)((char *)pNode + pList->countOffset);
+		for (; pPrev && *(size_t *)((char *)pPrev + pList->countOffset) < count; pPrev = *_GetPrevPointer(pPrev, pList->offset))
+		{
+			pBefore = pPrev;
+		}
+	}
+
+	if (!pBefore)
+	{
+		return pFound;
+	}
+
+	_UnlinkNode(pNode, pList);
+	_LinkBefore(pNode, pBefore, pList);
+
+	pPrev = *_GetPrevPointer(pNode, pList->offset);
+	return pPrev ? _GetNextPointer(pPrev, pList->offset) : &pList->pHead;
+}
+
+/**
+ * @brief Takes a node out of the chain without changing the list's length.
+ *
+ * @param pNode Pointer to the node.
+ * @param pFromList Pointer to the list holding the node.
+ */
+static void _UnlinkNode(void *pNode, DSL_List *pFromList)
+{
+	void **pNext = _GetNextPointer(pNode, pFromList->offset);
+	void **pPrev = _GetPrevPointer(pNode, pFromList->offset);
+
+	if (*pPrev)
+		*_GetNextPointer(*pPrev, pFromList->offset) = *pNext;
+	else
+		pFromList->pHead = *pNext;
+
+	if (*pNext)
+		*_GetPrevPointer(*pNext, pFromList->offset) = *pPrev;
+	else
+		pFromList->pTail = *pPrev;
 
-	// set the next pointer of the current tail to the new node
-	*pTailNext = pNode;
-	// set the previous pointer of the new node to the current tail
-	*pPrev = pOfList->pTail;
-	// set the tail of the list to the new node
-	pOfList->pTail = pNode;
-	// set the next pointer of the new node to NULL
 	*pNext = NULL;
+	*pPrev = NULL;
+}
+
+/**
+ * @brief Links an unlinked node into the chain right before another node.
+ *
+ * @param pNode Pointer to the node to link.
+ * @param pBefore Pointer to the node that will follow it.
+ * @param pOfList Pointer to the list holding pBefore.
+ */
+static void _LinkBefore(void *pNode, void *pBefore, DSL_List *pOfList)
+{
+	void *pPrev = *_GetPrevPointer(pBefore, pOfList->offset);
+
+	*_GetPrevPointer(pNode, pOfList->offset) = pPrev;
+	*_GetNextPointer(pNode, pOfList->offset) = pBefore;
+	*_GetPrevPointer(pBefore, pOfList->offset) = pNode;
+
+	if (pPrev)
+		*_GetNextPointer(pPrev, pOfList->offset) = pNode;
+	else
+		pOfList->pHead = pNode;
+}
+
+/**
+ * @brief Checks that two lists can be combined by a set operation and puts them in order.
+ *
+ * @param pA Pointer to the list that is changed, its order function is used.
+ * @param pB Pointer to the other list.
+ * @param pDiscard Pointer to the list that receives discarded nodes, or NULL.
+ * @return 1 if the lists can be combined, 0 otherwise.
+ */
+static int _CanCombine(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard)
+{
+	if (!pA || !pB || pA == pB || !pA->orderFunction || pA->offset != pB->offset)
+	{
+		return 0;
+	}
+
+	if (pDiscard == pA || pDiscard == pB)
+	{
+		return 0;
+	}
+
+	DSL_SettleOrder(pA);
+	DSL_SettleOrder(pB);
+	return 1;
+}
+
+/**
+ * @brief Unlinks the nodes of a list that do, or don't, have an equal node in another list.
+ *
+ * @param pA Pointer to the list that is reduced.
+ * @param pB Pointer to the list that is compared against.
+ * @param pDiscard Pointer to the list that receives the removed nodes, or NULL.
+ * @param discardMatches 1 to remove the nodes with a match, 0 to remove those without.
+ * @return The number of nodes removed.
+ */
+static size_t _FilterAgainst(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard, int discardMatches)
+{
+	size_t discarded = 0;
+	void *pNodeA = pA->pHead;
+	void *pNodeB = pB->pHead;
+
+	while (pNodeA)
+	{
+		// skip the nodes of pB that come before pNodeA
+		int order = 1;
+		while (pNodeB && (order = pA->orderFunction(pNodeA, pNodeB)) > 0)
+		{
+			pNodeB = *_GetNextPointer(pNodeB, pB->offset);
+		}
+
+		void *pNextA = *_GetNextPointer(pNodeA, pA->offset);
+		if ((pNodeB != NULL && order == 0) == (discardMatches != 0))
+		{
+			DSL_RemoveNode(pNodeA, pA);
+			if (pDiscard)
+				_AppendNode(pNodeA, pDiscard);
+			discarded++;
+		}
+		pNodeA = pNextA;
+	}
+
+	return discarded;
+}
+
+/**
+ * @brief Frees a filter and its counters.
+ *
+ * @param pFilter Pointer to the filter, may be NULL.
+ */
+static void _ReleaseFilter(DSL_Filter *pFilter)
+{
+	if (!pFilter)
+	{
+		return;
+	}
+
+	free(pFilter->pCounters);
+	free(pFilter);
+}
+
+/**
+ * @brief Appends a node to the tail of a doubly linked list.
+ *
+ * Unlike _InsertNodeAtTail this handles an empty list and increments the count.
+ *
+ * @param pNode Pointer to the node to append.
+ * @param pOfList Pointer to the list to append the node to.
+ */
+static void _AppendNode(void *pNode, DSL_List *pOfList)
+{
+	if (pOfList->length == 0)
+	{
+		pOfList->pHead = pNode;
+		pOfList->pTail = pNode;
+		*_GetNextPointer(pNode, pOfList->offset) = NULL;
+		*_GetPrevPointer(pNode, pOfList->offset) = NULL;
+	}
+	else
+	{
+		_InsertNodeAtTail(pNode, pOfList);
+	}
+
+	_FilterUpdate(pOfList, pNode, 1);
+	pOfList->length++;
+}
+
+/**
+ * @brief Copies the nodes of a list into one block, see DSL_Compact.
+ *
+ * @param pList Pointer to the list.
+ * @param nodeSize The size of each node in bytes.
+ * @param pRelocate Function that is told where each node moved, may be NULL.
+ * @param pCtx Context pointer passed to pRelocate.
+ * @param isDSLNode 1 if the nodes are DSL_Node, whose dynamic flags are then managed.
+ * @return 1 on success, 0 if the block could not be allocated and the list is unchanged.
+ */
+static int _CompactList(DSL_List *pList, size_t nodeSize, RelocateFunction pRelocate, void *pCtx, int isDSLNode)
+{
+	if (!pList || nodeSize < pList->offset + 2 * sizeof(void *))
+	{
+		return 0;
+	}
+
+	// copy the nodes in their final order
+	DSL_SettleOrder(pList);
+
+	void *pOldBlock = pList->pBlock;
+
+	if (pList->length == 0)
+	{
+		free(pOldBlock);
+		pList->pBlock = NULL;
+		return 1;
+	}
+
+	char *pBlock = malloc(pList->length * nodeSize);
+	if (!pBlock)
+	{
+		return 0;
+	}
+
+	void *pOld = pList->pHead;
+
+	for (size_t i = 0; i < pList->length; i++)
+	{
+		void *pNew = pBlock + (i * nodeSize);
+		void *pOldNext = *_GetNextPointer(pOld, pList->offset);
+
+		memcpy(pNew, pOld, nodeSize);
+
+		// neighbours in the list are now neighbours in memory
+		*_GetNextPointer(pNew, pList->offset) = i + 1 < pList->length ? (char *)pNew + nodeSize : NULL;
+		*_GetPrevPointer(pNew, pList->offset) = i > 0 ? (char *)pNew - nodeSize : NULL;
+
+		if (pRelocate)
+		{
+			pRelocate(pOld, pNew, pCtx);
+		}
+
+		if (isDSLNode)
+		{
+			// the copy lives in the block, so it must never be freed on its own
+			((DSL_Node *)pNew)->dynamic = 0;
+			if (((DSL_Node *)pOld)->dynamic == 1)
+				free(pOld);
+		}
+
+		pOld = pOldNext;
+	}
+
+	pList->pHead = pBlock;
+	pList->pTail = pBlock + ((pList->length - 1) * nodeSize);
+	pList->pBlock = pBlock;
+
+	// nodes from the previous compaction were copied out above
+	free(pOldBlock);
+	return 1;
+}
+
+/**
+ * @brief Destructor used by DSL_DestroyList to release DSL_Node nodes.
+ *
+ * @param pNode Pointer to the node to destroy.
+ * @param pCtx Pointer to the list's arena, whose nodes are left to it, may be NULL.
+ */
+static void _DestroyNodeCallback(void *pNode, void *pCtx)
+{
+	if (!_ArenaOwns(pCtx, pNode))
+		DSL_DestroyNode((DSL_Node *)pNode);
+}
+
+/**
+ * @brief Gets the pointer to the generation counter of a slot map element.
+ *
+ * @param pMap Pointer to the slot map that owns the element.
+ * @param pElement Pointer to the element in the backing array.
+ * @return Pointer to the element's generation.
+ */
+static uint32_t *_GetSlotGeneration(DSL_SlotMap *pMap, void *pElement)
+{
+	return (uint32_t *)((char *)pElement + pMap->generationOffset);
 }
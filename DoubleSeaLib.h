@@ -1,14 +1,20 @@
 #pragma once
 
-#ifdef DOUBLESEALIB_EXPORTS
+// DOUBLESEALIB_STATIC is defined when building or linking the static library
+#if defined(DOUBLESEALIB_STATIC)
+#define DOUBLE_SEA_LIB_API
+#elif !defined(_WIN32)
+#define DOUBLE_SEA_LIB_API __attribute__((visibility("default")))
+#elif defined(DOUBLESEALIB_EXPORTS)
 #define DOUBLE_SEA_LIB_API __declspec(dllexport)
 #else
 #define DOUBLE_SEA_LIB_API __declspec(dllimport)
-#endif // DOUBLESEALIB_EXPORTS
+#endif // DOUBLESEALIB_STATIC
 
 #ifndef DOUBLE_SEA_LIST_H
 #define DOUBLE_SEA_LIST_H
 #include <stddef.h>
+#include <stdint.h>
 
 // __________________________ Typedefs and Structures __________________________
 /**
@@ -22,6 +28,35 @@
  */
 typedef int (*OrderFunction)(void *pNode1, void *pNode2);
 
+/**
+ * @brief PredicateFunction is a function pointer type that is used to test a node.
+ *
+ * @param pNode The node to test.
+ * @param pCtx A caller supplied context pointer.
+ *
+ * @return int Returns non-zero if the node matches, and 0 if it does not.
+ */
+typedef int (*PredicateFunction)(void *pNode, void *pCtx);
+
+/**
+ * @brief DestructorFunction is a function pointer type that is used to release a node.
+ *
+ * The node has already been unlinked from its list when the function is called.
+ *
+ * @param pNode The node to release.
+ * @param pCtx A caller supplied context pointer.
+ */
+typedef void (*DestructorFunction)(void *pNode, void *pCtx);
+
+/**
+ * @brief RelocateFunction is a function pointer type that is called when a node is moved.
+ *
+ * @param pOldNode The node's previous address, it is no longer linked into the list.
+ * @param pNewNode The node's new address.
+ * @param pCtx A caller supplied context pointer.
+ */
+typedef void (*RelocateFunction)(void *pOldNode, void *pNewNode, void *pCtx);
+
 /**
  * @brief DSL_Node is a structure that represents a node in a doubly linked list.
  *
@@ -38,6 +73,63 @@ typedef struct DSL_Node
 	int dynamic;
 } DSL_Node;
 
+/**
+ * @brief DSL_Arena is a region of memory blocks that a list bump-allocates nodes from.
+ *
+ * @param pFirst A void pointer to the first block of the region.
+ * @param pCurrent A void pointer to the block allocations are currently served from.
+ * @param blockSize The default size in bytes of a new block.
+ * @param blockCount The number of blocks owned by the region.
+ */
+typedef struct DSL_Arena
+{
+	void *pFirst;
+	void *pCurrent;
+	size_t blockSize;
+	size_t blockCount;
+} DSL_Arena;
+
+/**
+ * @brief DSL_Filter is a counting Bloom filter over the data pointers held by a list.
+ *
+ * Counters saturate at 255 and are never decremented afterwards, so the filter can
+ * report false positives but never false negatives.
+ *
+ * @param pCounters A pointer to the counters, one byte each.
+ * @param counterCount The number of counters, a power of two.
+ * @param hashCount The number of counters each item touches.
+ * @param definiteMisses The number of lookups the filter answered without scanning.
+ * @param falsePositives The number of lookups the filter let through that found nothing.
+ */
+typedef struct DSL_Filter
+{
+	uint8_t *pCounters;
+	size_t counterCount;
+	size_t hashCount;
+	size_t definiteMisses;
+	size_t falsePositives;
+} DSL_Filter;
+
+/**
+ * @brief DSL_FilterStats reports the size and accuracy of a list's filter.
+ *
+ * @param memoryBytes The memory used by the counters.
+ * @param counterCount The number of counters.
+ * @param hashCount The number of counters each item touches.
+ * @param estimatedFalsePositiveRate The expected false positive rate at the list's current length.
+ * @param definiteMisses The number of lookups the filter answered without scanning.
+ * @param falsePositives The number of lookups the filter let through that found nothing.
+ */
+typedef struct DSL_FilterStats
+{
+	size_t memoryBytes;
+	size_t counterCount;
+	size_t hashCount;
+	double estimatedFalsePositiveRate;
+	size_t definiteMisses;
+	size_t falsePositives;
+} DSL_FilterStats;
+
 /**
  * @brief DSL_List is a structure that represents a list.
  *
@@ -47,6 +139,15 @@ typedef struct DSL_Node
  * @param length The number of nodes in the list.
  * @param offset The offset to the data in the node.
  * @param orderFunction A function pointer to the function that compares two nodes.
+ * @param pBlock A void pointer to the contiguous node storage created by DSL_Compact.
+ * @param deferredOrder A flag that indicates if ordered inserts are deferred.
+ * @param pPending A void pointer to the first node of the unsorted tail segment.
+ * @param pArena A pointer to the region the list allocates its nodes from, or NULL.
+ * @param pFilter A pointer to the membership filter of the list, or NULL.
+ * @param organizePolicy The DSL_ORGANIZE_* policy applied to nodes found by DSL_FindNode.
+ * @param countOffset The offset to the size_t access counter used by DSL_ORGANIZE_COUNT.
+ * @param findCount The number of DSL_FindNode lookups since the scan statistics were reset.
+ * @param findDepth The number of nodes those lookups compared.
  */
 typedef struct DSL_List
 {
@@ -56,6 +157,15 @@ typedef struct DSL_List
 	size_t length;
 	size_t offset;
 	OrderFunction orderFunction;
+	void *pBlock;
+	int deferredOrder;
+	void *pPending;
+	DSL_Arena *pArena;
+	DSL_Filter *pFilter;
+	int organizePolicy;
+	size_t countOffset;
+	size_t findCount;
+	size_t findDepth;
 } DSL_List;
 
 /**
@@ -81,12 +191,76 @@ typedef struct DSL_InitStaticStorageListArgs
 	OrderFunction orderFunction;
 } DSL_InitStaticStorageListArgs;
 
+/**
+ * @brief DSL_Handle is a stable reference to an element of a DSL_SlotMap.
+ *
+ * The low 32 bits hold the element's index into the backing array and the high
+ * 32 bits hold the generation the element had when it was allocated.
+ */
+typedef uint64_t DSL_Handle;
+
+/**
+ * @brief DSL_SlotMap is a structure that hands out generation checked handles to the
+ * 		  elements of a static storage array.
+ *
+ * @param freeList An intrusive list of the elements that are not allocated.
+ * @param data A void pointer to the elements of the backing array.
+ * @param maxItems The number of elements in the backing array.
+ * @param structSize The size of the structure that the slot map holds.
+ * @param indexOffset The offset to the index field in the structure.
+ * @param generationOffset The offset to the uint32_t generation field in the structure.
+ */
+typedef struct DSL_SlotMap
+{
+	DSL_List freeList;
+	void *data;
+	size_t maxItems;
+	size_t structSize;
+	size_t indexOffset;
+	size_t generationOffset;
+} DSL_SlotMap;
+
+/**
+ * @brief DSL_InitSlotMapArgs is a structure that holds the arguments for the
+ * 		  DSL_InitSlotMap function.
+ *
+ * @param data A void pointer to the elements that the slot map will hold.
+ * @param offset The offset to the pNext pointer in the element.
+ * @param maxItems The number of elements in the array, at most DSL_HANDLE_MAX_INDEX + 1.
+ * @param pMap A pointer to the slot map that will be initialized.
+ * @param structSize The size of the structure that the slot map will hold.
+ * @param indexOffset The offset to the index field in the structure.
+ * @param generationOffset The offset to the uint32_t generation field in the structure.
+ */
+typedef struct DSL_InitSlotMapArgs
+{
+	void *data;
+	size_t offset;
+	size_t maxItems;
+	DSL_SlotMap *pMap;
+	size_t structSize;
+	size_t indexOffset;
+	size_t generationOffset;
+} DSL_InitSlotMapArgs;
+
 typedef DSL_List DSL_DynamicList; // Alias for the dynamic list
 typedef DSL_Node DSL_DynamicNode; // Alias for the dynamic node
 
 // __________________________ Macros __________________________
 
 #define OFFSETOF_DSL_NODE offsetof(DSL_Node, pNext) // Offset to the pNext field in the DSL_Node structure
+#define DSL_CACHE_LINE_SIZE 64                       // Padding used to keep concurrently written fields apart
+#define DSL_ARENA_ALIGNMENT 16                       // Alignment of every arena allocation
+
+#define DSL_ORGANIZE_NONE 0          // Found nodes stay where they are
+#define DSL_ORGANIZE_MOVE_TO_FRONT 1 // A found node moves to the head
+#define DSL_ORGANIZE_TRANSPOSE 2     // A found node swaps places with its predecessor
+#define DSL_ORGANIZE_COUNT 3         // A found node moves ahead of the nodes found less often
+
+#define DSL_INVALID_HANDLE ((DSL_Handle)0)                           // Never resolves to an element
+#define DSL_HANDLE_MAX_INDEX ((size_t)0xFFFFFFFFu)                   // Largest index a handle can address
+#define DSL_HANDLE_INDEX(handle) ((size_t)((handle) & 0xFFFFFFFFu))  // Index part of a handle
+#define DSL_HANDLE_GENERATION(handle) ((uint32_t)((handle) >> 32))   // Generation part of a handle
 
 // __________________________ Function Prototypes __________________________
 
@@ -162,6 +336,230 @@ DOUBLE_SEA_LIB_API void DSL_Push(void *pNode, DSL_List *pIntoList);
  */
 DOUBLE_SEA_LIB_API void DSL_InitStaticStorageListWData(DSL_InitStaticStorageListArgs *pArgs);
 
+/**
+ * @brief DSL_EnableArena gives a list its own allocation region
+ *
+ * After this, DSL_ArenaAlloc and DSL_ArenaAllocNode bump-allocate from blocks owned by the
+ * list. Destroying or resetting the list releases the whole region in O(blocks). Arena
+ * nodes are never freed one by one, but DSL_DestroyList still frees dynamic nodes that came
+ * from elsewhere. DSL_ResetList doesn't visit nodes, so those have to be removed first.
+ *
+ * @param pList - A pointer to the list
+ * @param blockSize - The size in bytes of each block the region grows by
+ * @return int - 1 on success, 0 if the region could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_EnableArena(DSL_List *pList, size_t blockSize);
+
+/**
+ * @brief DSL_ArenaAlloc allocates memory from a list's arena
+ *
+ * Memory is aligned to DSL_ARENA_ALIGNMENT and lives until the list is reset or destroyed.
+ * Use it for payloads that should share the lifetime of the list's nodes.
+ *
+ * @param pList - A pointer to a list with an arena
+ * @param size - The number of bytes to allocate
+ * @return void* - A pointer to the memory, or NULL if the list has no arena or a block could not be allocated
+ */
+DOUBLE_SEA_LIB_API void *DSL_ArenaAlloc(DSL_List *pList, size_t size);
+
+/**
+ * @brief DSL_ArenaAllocNode allocates and initializes a DSL_Node from a list's arena
+ *
+ * The node is not dynamic, so DSL_DestroyNode never frees it on its own.
+ *
+ * @param pList - A pointer to a list with an arena
+ * @param pWithData - A pointer to the data that the node will hold
+ * @return DSL_Node* - A pointer to the node, or NULL if it could not be allocated
+ */
+DOUBLE_SEA_LIB_API DSL_Node *DSL_ArenaAllocNode(DSL_List *pList, void *pWithData);
+
+/**
+ * @brief DSL_ResetList empties a list without visiting its nodes
+ *
+ * The list keeps its offset, order function and modes. If it has an arena, the region is
+ * rewound so its blocks are reused by the next allocations instead of going back to the
+ * system allocator. Nodes that were in the list are simply forgotten.
+ *
+ * @param pList - A pointer to the list that will be reset
+ */
+DOUBLE_SEA_LIB_API void DSL_ResetList(DSL_List *pList);
+
+/**
+ * @brief DSL_EnableFilter adds a counting Bloom filter to a list
+ *
+ * The filter is sized for expectedItems at the requested false positive rate and is kept
+ * up to date by every insert, push, remove and pop. DSL_FindNode and DSL_Contains use it
+ * to return immediately for data that is definitely not in the list. Nodes already in the
+ * list are added to the new filter, an existing filter is replaced.
+ *
+ * @param pList - A pointer to the list
+ * @param expectedItems - The number of nodes the filter is sized for
+ * @param falsePositiveRate - The target false positive rate, between 0 and 1
+ * @return int - 1 on success, 0 if the filter could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_EnableFilter(DSL_List *pList, size_t expectedItems, double falsePositiveRate);
+
+/**
+ * @brief DSL_DisableFilter removes the filter from a list
+ *
+ * @param pList - A pointer to the list
+ */
+DOUBLE_SEA_LIB_API void DSL_DisableFilter(DSL_List *pList);
+
+/**
+ * @brief DSL_RebuildFilter recomputes a list's filter from its nodes
+ *
+ * Needed after nodes were linked into the list by hand, and clears counters that saturated.
+ *
+ * @param pList - A pointer to the list
+ */
+DOUBLE_SEA_LIB_API void DSL_RebuildFilter(DSL_List *pList);
+
+/**
+ * @brief DSL_GetFilterStats reports the memory use and accuracy of a list's filter
+ *
+ * @param pList - A pointer to the list
+ * @param pStats - A pointer to the structure that receives the statistics
+ * @return int - 1 if the list has a filter, 0 otherwise
+ */
+DOUBLE_SEA_LIB_API int DSL_GetFilterStats(DSL_List *pList, DSL_FilterStats *pStats);
+
+/**
+ * @brief DSL_Contains checks if a list holds a node with the given data
+ *
+ * Returns immediately when the list's filter rules the data out, otherwise falls back
+ * to DSL_FindNode, so the answer is always exact.
+ *
+ * @param pList - A pointer to the list that will be searched
+ * @param pWithData - A pointer to the data to look for
+ * @return int - 1 if a node holds the data, 0 otherwise
+ */
+DOUBLE_SEA_LIB_API int DSL_Contains(DSL_List *pList, void *pWithData);
+
+/**
+ * @brief DSL_SetDeferredOrder turns deferred ordering on or off for a list
+ *
+ * While deferred ordering is on, DSL_InsertNode appends to an unsorted pending segment
+ * at the tail in O(1) instead of scanning for the node's position. The first operation
+ * that needs order (DSL_Pop, DSL_FindNode, DSL_SettleOrder) sorts the pending segment and
+ * merges it into the ordered part. Turning it off settles the list immediately.
+ *
+ * @param pList - A pointer to the list
+ * @param enable - 1 to defer ordering, 0 to order on every insert
+ */
+DOUBLE_SEA_LIB_API void DSL_SetDeferredOrder(DSL_List *pList, int enable);
+
+/**
+ * @brief DSL_SettleOrder puts any pending nodes of a list in order
+ *
+ * Sorts the pending segment with a stable merge sort and merges it into the ordered part
+ * of the list, so nodes with equal keys keep their insertion order. Call this before
+ * walking pHead/pNext directly on a list with deferred ordering.
+ *
+ * @param pList - A pointer to the list that will be settled
+ */
+DOUBLE_SEA_LIB_API void DSL_SettleOrder(DSL_List *pList);
+
+/**
+ * @brief DSL_MergeK merges k ordered lists into one list in a single pass
+ *
+ * Relinks the nodes of every source list, and any nodes already in pIntoList, into one
+ * ordered list in pIntoList. The lists are merged pairwise in rounds, so every node takes
+ * part in log2(k) merges and the cost is O(n log k) without allocating. Equal nodes keep
+ * the order of their lists, with pIntoList's own nodes first. pIntoList's order function is
+ * used, or the sources' if it has none. The source lists must be distinct, must not include
+ * pIntoList, and must share its offset and that order function, otherwise nothing is moved.
+ * The source lists are left empty.
+ *
+ * @param ppLists - An array of k pointers to the ordered lists that will be merged
+ * @param k - The number of source lists
+ * @param pIntoList - A pointer to the list that receives the nodes
+ * @return size_t - The number of nodes moved from the source lists
+ */
+DOUBLE_SEA_LIB_API size_t DSL_MergeK(DSL_List **ppLists, size_t k, DSL_List *pIntoList);
+
+/**
+ * @brief DSL_Union moves the nodes of one ordered list into another, skipping duplicates
+ *
+ * Walks both lists once and relinks every node of pB into its place in pA, unless pA
+ * already holds an equal node. Those duplicates are appended to pDiscard, or just unlinked
+ * when it is NULL. pB is left empty. Both lists must be ordered by pA's order function and
+ * share an offset. Equal nodes within pA are kept, see DSL_Dedup.
+ *
+ * @param pA - A pointer to the list that receives the union
+ * @param pB - A pointer to the list whose nodes are moved
+ * @param pDiscard - A pointer to the list that receives the duplicates, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+DOUBLE_SEA_LIB_API size_t DSL_Union(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard);
+
+/**
+ * @brief DSL_Intersect keeps only the nodes of an ordered list that another list also holds
+ *
+ * Walks both lists once and unlinks every node of pA without an equal node in pB. Those
+ * nodes are appended to pDiscard, or just unlinked when it is NULL. pB is not changed.
+ * Both lists must be ordered by pA's order function and share an offset.
+ *
+ * @param pA - A pointer to the list that is reduced to the intersection
+ * @param pB - A pointer to the list that is intersected with
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+DOUBLE_SEA_LIB_API size_t DSL_Intersect(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard);
+
+/**
+ * @brief DSL_Difference removes the nodes of an ordered list that another list also holds
+ *
+ * Walks both lists once and unlinks every node of pA with an equal node in pB. Those nodes
+ * are appended to pDiscard, or just unlinked when it is NULL. pB is not changed. Both
+ * lists must be ordered by pA's order function and share an offset.
+ *
+ * @param pA - A pointer to the list that is reduced to the difference
+ * @param pB - A pointer to the list whose nodes are subtracted
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+DOUBLE_SEA_LIB_API size_t DSL_Difference(DSL_List *pA, DSL_List *pB, DSL_List *pDiscard);
+
+/**
+ * @brief DSL_Dedup removes all but the first of every run of equal nodes in an ordered list
+ *
+ * The removed nodes are appended to pDiscard, or just unlinked when it is NULL.
+ *
+ * @param pList - A pointer to the ordered list
+ * @param pDiscard - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes discarded
+ */
+DOUBLE_SEA_LIB_API size_t DSL_Dedup(DSL_List *pList, DSL_List *pDiscard);
+
+/**
+ * @brief DSL_FindStaticStorageNode finds a node in a static storage array by its data
+ *
+ * Scans the backing array of a list created with DSL_InitStaticStorageListWData directly
+ * instead of following links, comparing the data pointer stored just before each element's
+ * pNext pointer, the same field DSL_FindNode compares. The scan uses AVX2 or SSE2 when the
+ * CPU supports them. Every element of the array is checked, whether or not it is still linked.
+ *
+ * @param pArgs - A pointer to the arguments the list was initialized with
+ * @param pWithData - A pointer to the data that the node holds
+ * @return void* - A pointer to the first matching element, or NULL
+ */
+DOUBLE_SEA_LIB_API void *DSL_FindStaticStorageNode(DSL_InitStaticStorageListArgs *pArgs, void *pWithData);
+
+/**
+ * @brief DSL_FindStaticStorageKey finds a node in a static storage array by an integer key
+ *
+ * Scans the backing array for the first element whose integer field at keyOffset equals
+ * key, using AVX2 or SSE2 when the CPU supports them.
+ *
+ * @param pArgs - A pointer to the arguments the list was initialized with
+ * @param keyOffset - The offset to the key field in the structure
+ * @param keySize - The size of the key field, 4 or 8 bytes
+ * @param key - The key to look for
+ * @return void* - A pointer to the first matching element, or NULL
+ */
+DOUBLE_SEA_LIB_API void *DSL_FindStaticStorageKey(DSL_InitStaticStorageListArgs *pArgs, size_t keyOffset, size_t keySize, int64_t key);
+
 /**
  * @brief DSL_RemoveNode removes a node from a list
  *
@@ -188,12 +586,82 @@ DOUBLE_SEA_LIB_API void DSL_InsertNode(void *pNode, DSL_List *pIntoList);
  * Destroys a list and frees the memory the struct occupies if it is dynamic.
  * Otherwise, the list is reset to default values but it's memory is not freed.
  * Destroying a list, will also destroy all of it's nodes if the cleanNodes flag is set.
+ * Nodes that live in the list's arena are skipped, the arena is released as a whole.
  *
  * @param pList - A pointer to the list that will be destroyed
  * @param cleanNodes - A flag that indicates if the nodes of the list will be destroyed
  */
 DOUBLE_SEA_LIB_API void DSL_DestroyList(DSL_List *pList, int cleanNodes);
 
+/**
+ * @brief DSL_DestroyListEx destroys a list with a destructor callback
+ *
+ * Walks the list once using its offset, so it works with any intrusive structure, and
+ * calls the destructor on every node after unlinking it. The list struct is then freed
+ * if it is dynamic or reset to default values otherwise. When pDestructor is NULL the
+ * nodes are not visited and are simply detached from the list. A list's arena is released
+ * after the destructor has run.
+ *
+ * @param pList - A pointer to the list that will be destroyed
+ * @param pDestructor - A function that releases each node, or NULL
+ * @param pCtx - A context pointer that is passed to the destructor
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroyListEx(DSL_List *pList, DestructorFunction pDestructor, void *pCtx);
+
+/**
+ * @brief DSL_Compact relocates the nodes of a list into contiguous memory
+ *
+ * Copies every node into a single freshly allocated block in traversal order and rewrites
+ * the links, so walking the list becomes a sequential scan. The block is owned by the list
+ * and released by the next compaction or when the list is destroyed.
+ *
+ * pRelocate is called once per node with its old and new address so external references
+ * can be fixed up. The nodes are copied as opaque bytes and the old nodes are left untouched,
+ * so the caller may reuse or release them, unless they came from an earlier compaction of
+ * this list. Lists of DSL_Node should use DSL_CompactNodes, which frees the dynamic ones.
+ *
+ * Once compacted, a node belongs to the block. A node that is later unlinked, for example by
+ * DSL_RemoveNode or DSL_Pop, still lives in the block and becomes invalid at the next
+ * compaction or when the list is destroyed, so copy it out first if it has to outlive those.
+ *
+ * @param pList - A pointer to the list that will be compacted
+ * @param nodeSize - The size of each node in bytes
+ * @param pRelocate - A function that is told where each node moved, or NULL
+ * @param pCtx - A context pointer that is passed to pRelocate
+ * @return int - 1 on success, 0 if the block could not be allocated and the list is unchanged
+ */
+DOUBLE_SEA_LIB_API int DSL_Compact(DSL_List *pList, size_t nodeSize, RelocateFunction pRelocate, void *pCtx);
+
+/**
+ * @brief DSL_CompactNodes relocates the DSL_Node nodes of a list into contiguous memory
+ *
+ * Works like DSL_Compact with a nodeSize of sizeof(DSL_Node), and manages the nodes' dynamic
+ * flags: dynamic originals are freed after pRelocate has been called and the copies are
+ * marked non-dynamic. Non-dynamic originals are left untouched and belong to the caller.
+ *
+ * @param pList - A pointer to a list of DSL_Node that will be compacted
+ * @param pRelocate - A function that is told where each node moved, or NULL
+ * @param pCtx - A context pointer that is passed to pRelocate
+ * @return int - 1 on success, 0 if the list doesn't use OFFSETOF_DSL_NODE or the block could
+ * 				 not be allocated, the list is unchanged then
+ */
+DOUBLE_SEA_LIB_API int DSL_CompactNodes(DSL_List *pList, RelocateFunction pRelocate, void *pCtx);
+
+/**
+ * @brief DSL_RemoveIf removes every matching node from a list
+ *
+ * Unlinks all nodes that match the predicate in a single traversal. Removed nodes are
+ * appended to the tail of pOutList in list order when it is provided, the output list
+ * must use the same offset as pFromList.
+ *
+ * @param pFromList - A pointer to the list from which the nodes will be removed
+ * @param pPredicate - A function that returns non-zero for the nodes to remove
+ * @param pCtx - A context pointer that is passed to the predicate
+ * @param pOutList - A pointer to the list that receives the removed nodes, or NULL
+ * @return size_t - The number of nodes removed
+ */
+DOUBLE_SEA_LIB_API size_t DSL_RemoveIf(DSL_List *pFromList, PredicateFunction pPredicate, void *pCtx, DSL_List *pOutList);
+
 /**
  * @brief DSL_FindNode finds a node in a list
  *
@@ -205,6 +673,57 @@ DOUBLE_SEA_LIB_API void DSL_DestroyList(DSL_List *pList, int cleanNodes);
  */
 DOUBLE_SEA_LIB_API void **DSL_FindNode(DSL_List *pList, void *pWithData);
 
+/**
+ * @brief DSL_FindNodeBatch finds the nodes for many data pointers in one pass over a list
+ *
+ * Equivalent to calling DSL_FindNode for every entry of ppWithData, but the list is walked
+ * once for the whole batch and each node is checked against all outstanding lookups, so a
+ * list that doesn't fit in cache is only brought in once. The walk stops as soon as every
+ * lookup has been answered. Every lookup is counted in the scan statistics. Self-organizing
+ * lists move nodes on every hit, so their lookups are answered one by one with DSL_FindNode.
+ *
+ * @param pList - A pointer to the list that the nodes will be searched in
+ * @param ppWithData - An array of count pointers to the data to look for
+ * @param count - The number of lookups
+ * @param pppResults - An array of count entries that receives what DSL_FindNode would return
+ * @return size_t - The number of lookups that found a node
+ */
+DOUBLE_SEA_LIB_API size_t DSL_FindNodeBatch(DSL_List *pList, void **ppWithData, size_t count, void ***pppResults);
+
+/**
+ * @brief DSL_SetSelfOrganizing picks how an unordered list reorders itself on lookups
+ *
+ * With a policy other than DSL_ORGANIZE_NONE, every node found by DSL_FindNode (and so
+ * DSL_Contains) is moved towards the head, so frequently looked up nodes are found after
+ * fewer hops. DSL_ORGANIZE_COUNT keeps a size_t access counter in each node at countOffset
+ * and keeps the list sorted by it, the counters have to start at 0. Ordered lists keep
+ * their order and can't self-organize.
+ *
+ * @param pList - A pointer to the list
+ * @param policy - One of the DSL_ORGANIZE_* policies
+ * @param countOffset - The offset to the access counter in the node, used by DSL_ORGANIZE_COUNT
+ * @return int - 1 on success, 0 if the list is ordered or the policy is unknown
+ */
+DOUBLE_SEA_LIB_API int DSL_SetSelfOrganizing(DSL_List *pList, int policy, size_t countOffset);
+
+/**
+ * @brief DSL_AverageScanDepth returns the average number of nodes DSL_FindNode compared
+ *
+ * Counts every lookup that reached the list, hits and misses, since the list was
+ * initialized or DSL_ResetScanStats was called.
+ *
+ * @param pList - A pointer to the list
+ * @return double - The average number of nodes compared per lookup, 0 if there were none
+ */
+DOUBLE_SEA_LIB_API double DSL_AverageScanDepth(DSL_List *pList);
+
+/**
+ * @brief DSL_ResetScanStats clears the lookup counters of a list
+ *
+ * @param pList - A pointer to the list
+ */
+DOUBLE_SEA_LIB_API void DSL_ResetScanStats(DSL_List *pList);
+
 /**
  * @brief DSL_InitNode initializes a dynamic node
  *
@@ -228,4 +747,61 @@ DOUBLE_SEA_LIB_API void DSL_InitNode(int isDynamic, DSL_Node *pNode, void *pWith
  */
 DOUBLE_SEA_LIB_API void DSL_InitList(int isDynamic, size_t offset, DSL_List *pList, OrderFunction pOrderFunction);
 
+/**
+ * @brief DSL_InitSlotMap initializes a slot map over a static storage array
+ *
+ * Writes each element's index at `pArgs->indexOffset`, resets its generation and threads
+ * every element onto the slot map's free list. Generations are odd while an element is
+ * allocated and even while it is free, so a handle is only ever valid for the allocation
+ * that produced it. Nothing is initialized if `pArgs->maxItems` exceeds DSL_HANDLE_MAX_INDEX + 1.
+ *
+ * @param pArgs - A pointer to the arguments that will be used to initialize the slot map
+ */
+DOUBLE_SEA_LIB_API void DSL_InitSlotMap(DSL_InitSlotMapArgs *pArgs);
+
+/**
+ * @brief DSL_SlotMapAlloc allocates an element from a slot map
+ *
+ * Takes the first element off the free list in O(1) and starts a new generation for it.
+ * The element's links are free for the caller to use while it is allocated.
+ *
+ * @param pMap - A pointer to the slot map to allocate from
+ * @param pOutHandle - A pointer that receives the handle of the element, or DSL_INVALID_HANDLE
+ * @return void* - A pointer to the allocated element, or NULL if the slot map is full
+ */
+DOUBLE_SEA_LIB_API void *DSL_SlotMapAlloc(DSL_SlotMap *pMap, DSL_Handle *pOutHandle);
+
+/**
+ * @brief DSL_SlotMapFree returns an element to a slot map
+ *
+ * Ends the element's generation, so every outstanding handle to it becomes stale, and
+ * pushes it onto the free list in O(1). The element must not be linked into another list
+ * through the slot map's links when it is freed.
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param handle - The handle of the element that will be freed
+ * @return int - 1 if the element was freed, 0 if the handle was stale or invalid
+ */
+DOUBLE_SEA_LIB_API int DSL_SlotMapFree(DSL_SlotMap *pMap, DSL_Handle handle);
+
+/**
+ * @brief DSL_SlotMapGet resolves a handle to its element
+ *
+ * Resolves the handle in O(1) by indexing the backing array and comparing generations.
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param handle - The handle that will be resolved
+ * @return void* - A pointer to the element, or NULL if the handle is stale or invalid
+ */
+DOUBLE_SEA_LIB_API void *DSL_SlotMapGet(DSL_SlotMap *pMap, DSL_Handle handle);
+
+/**
+ * @brief DSL_SlotMapHandleOf gets the handle of an allocated element
+ *
+ * @param pMap - A pointer to the slot map that owns the element
+ * @param pElement - A pointer to the element in the backing array
+ * @return DSL_Handle - The handle of the element, or DSL_INVALID_HANDLE if it is not allocated
+ */
+DOUBLE_SEA_LIB_API DSL_Handle DSL_SlotMapHandleOf(DSL_SlotMap *pMap, void *pElement);
+
 #endif // DOUBLE_SEA_LIST_H
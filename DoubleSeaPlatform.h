@@ -0,0 +1,98 @@
+// DoubleSeaPlatform.h: Internal wrappers over the compiler and OS primitives used by the
+// concurrent containers. Not part of the public interface.
+
+#pragma once
+
+#ifndef DOUBLE_SEA_PLATFORM_H
+#define DOUBLE_SEA_PLATFORM_H
+#include <stdint.h>
+
+// __________________________ Atomics __________________________
+
+#ifdef _WIN32
+#include <windows.h>
+
+#define DSL_LoadRelaxed64(p) ReadNoFence64((volatile LONG64 *)(p))
+#define DSL_LoadAcquire64(p) ReadAcquire64((volatile LONG64 *)(p))
+#define DSL_StoreRelaxed64(p, v) WriteNoFence64((volatile LONG64 *)(p), (v))
+#define DSL_StoreRelease64(p, v) WriteRelease64((volatile LONG64 *)(p), (v))
+#define DSL_CompareExchange64(p, expected, desired) \
+	(InterlockedCompareExchange64((volatile LONG64 *)(p), (desired), (expected)) == (expected))
+#define DSL_LoadPointerRelaxed(p) ReadPointerNoFence((PVOID volatile *)(p))
+#define DSL_LoadPointerAcquire(p) ReadPointerAcquire((PVOID volatile *)(p))
+#define DSL_StorePointerRelaxed(p, v) WritePointerNoFence((PVOID volatile *)(p), (v))
+#define DSL_StorePointerRelease(p, v) WritePointerRelease((PVOID volatile *)(p), (v))
+#define DSL_FetchAdd64(p, v) InterlockedExchangeAdd64((volatile LONG64 *)(p), (v))
+#define DSL_FenceSeqCst() MemoryBarrier()
+
+#else
+
+#define DSL_LoadRelaxed64(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define DSL_LoadAcquire64(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DSL_StoreRelaxed64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define DSL_StoreRelease64(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define DSL_CompareExchange64(p, expected, desired) \
+	__extension__({ int64_t _expected = (expected); \
+		__atomic_compare_exchange_n((p), &_expected, (desired), 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED); })
+#define DSL_LoadPointerRelaxed(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define DSL_LoadPointerAcquire(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define DSL_StorePointerRelaxed(p, v) __atomic_store_n((p), (v), __ATOMIC_RELAXED)
+#define DSL_StorePointerRelease(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define DSL_FetchAdd64(p, v) __atomic_fetch_add((p), (v), __ATOMIC_SEQ_CST)
+#define DSL_FenceSeqCst() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif // _WIN32
+
+// __________________________ Locks __________________________
+
+#ifdef _WIN32
+
+typedef SRWLOCK DSL_Mutex;
+#define DSL_InitMutex(p) InitializeSRWLock(p)
+#define DSL_DestroyMutex(p) ((void)(p))
+#define DSL_LockMutex(p) AcquireSRWLockExclusive(p)
+#define DSL_UnlockMutex(p) ReleaseSRWLockExclusive(p)
+
+#else
+#include <pthread.h>
+
+typedef pthread_mutex_t DSL_Mutex;
+#define DSL_InitMutex(p) pthread_mutex_init((p), NULL)
+#define DSL_DestroyMutex(p) pthread_mutex_destroy(p)
+#define DSL_LockMutex(p) pthread_mutex_lock(p)
+#define DSL_UnlockMutex(p) pthread_mutex_unlock(p)
+
+#endif // _WIN32
+
+// __________________________ Instruction Sets __________________________
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define DSL_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define DSL_TARGET_AVX2
+#else
+#define DSL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif // _MSC_VER
+
+// hint that a node will be read soon, so its cache miss overlaps with other work
+#if defined(DSL_HAS_X86)
+#define DSL_PREFETCH(p) _mm_prefetch((const char *)(p), _MM_HINT_T0)
+#elif defined(__GNUC__)
+#define DSL_PREFETCH(p) __builtin_prefetch((p))
+#else
+#define DSL_PREFETCH(p) ((void)(p))
+#endif
+
+// __________________________ Threads __________________________
+
+#ifdef _WIN32
+#define DSL_CurrentThreadId() ((size_t)GetCurrentThreadId())
+#else
+#define DSL_CurrentThreadId() ((size_t)pthread_self())
+#endif // _WIN32
+
+#endif // DOUBLE_SEA_PLATFORM_H
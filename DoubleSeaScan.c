@@ -0,0 +1,356 @@
+#include "pch.h"
+#include <string.h>
+#include "DoubleSeaLib.h"
+#include "DoubleSeaPlatform.h"
+
+// __________________________ Macros __________________________
+
+#define DSL_SCAN_SCALAR 0 // Plain loop, unrolled so loads are independent
+#define DSL_SCAN_SSE2 1   // 128-bit compares
+#define DSL_SCAN_AVX2 2   // 256-bit compares with gathers for strided fields
+
+// __________________________ Prototypes __________________________
+
+static int _GetScanLevel(void);
+static size_t _ScanField(const char *pBase, size_t stride, size_t count, size_t width, int64_t value);
+static int32_t _LoadField32(const char *pField);
+static int64_t _LoadField64(const char *pField);
+static size_t _ScanScalar32(const char *pBase, size_t stride, size_t count, int32_t value);
+static size_t _ScanScalar64(const char *pBase, size_t stride, size_t count, int64_t value);
+#ifdef DSL_HAS_X86
+static unsigned int _FirstSetBit(unsigned int mask);
+static size_t _ScanSSE2_32(const char *pBase, size_t stride, size_t count, int32_t value);
+static size_t _ScanSSE2_64(const char *pBase, size_t stride, size_t count, int64_t value);
+DSL_TARGET_AVX2 static size_t _ScanAVX2_32(const char *pBase, size_t stride, size_t count, int32_t value);
+DSL_TARGET_AVX2 static size_t _ScanAVX2_64(const char *pBase, size_t stride, size_t count, int64_t value);
+#endif // DSL_HAS_X86
+
+// __________________________ Functions __________________________
+
+/**
+ * @brief DSL_FindStaticStorageNode finds a node in a static storage array by its data
+ *
+ * Scans the backing array of a list created with DSL_InitStaticStorageListWData directly
+ * instead of following links, comparing the data pointer stored just before each element's
+ * pNext pointer, the same field DSL_FindNode compares. The scan uses AVX2 or SSE2 when the
+ * CPU supports them. Every element of the array is checked, whether or not it is still linked.
+ *
+ * @param pArgs - A pointer to the arguments the list was initialized with
+ * @param pWithData - A pointer to the data that the node holds
+ * @return void* - A pointer to the first matching element, or NULL
+ */
+void *DSL_FindStaticStorageNode(DSL_InitStaticStorageListArgs *pArgs, void *pWithData)
+{
+	if (!pArgs || !pWithData || pArgs->offset < sizeof(void *))
+	{
+		return NULL;
+	}
+
+	return DSL_FindStaticStorageKey(pArgs, pArgs->offset - sizeof(void *), sizeof(void *), (int64_t)(intptr_t)pWithData);
+}
+
+/**
+ * @brief DSL_FindStaticStorageKey finds a node in a static storage array by an integer key
+ *
+ * Scans the backing array for the first element whose integer field at keyOffset equals
+ * key, using AVX2 or SSE2 when the CPU supports them.
+ *
+ * @param pArgs - A pointer to the arguments the list was initialized with
+ * @param keyOffset - The offset to the key field in the structure
+ * @param keySize - The size of the key field, 4 or 8 bytes
+ * @param key - The key to look for
+ * @return void* - A pointer to the first matching element, or NULL
+ */
+void *DSL_FindStaticStorageKey(DSL_InitStaticStorageListArgs *pArgs, size_t keyOffset, size_t keySize, int64_t key)
+{
+	if (!pArgs || !pArgs->data || (keySize != 4 && keySize != 8) || keyOffset + keySize > pArgs->structSize)
+	{
+		return NULL;
+	}
+
+	const char *pBase = (const char *)pArgs->data + keyOffset;
+	size_t index = _ScanField(pBase, pArgs->structSize, pArgs->maxItems, keySize, key);
+	if (index == pArgs->maxItems)
+	{
+		return NULL;
+	}
+
+	return (char *)pArgs->data + (index * pArgs->structSize);
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Picks the widest scan the CPU supports, the answer is cached after the first call.
+ *
+ * @return One of the DSL_SCAN_* levels.
+ */
+static int _GetScanLevel(void)
+{
+	static volatile int level = -1;
+	if (level >= 0)
+	{
+		return level;
+	}
+
+	int detected = DSL_SCAN_SCALAR;
+#ifdef DSL_HAS_X86
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	if (info[3] & (1 << 26))
+		detected = DSL_SCAN_SSE2;
+
+	// AVX2 also needs the OS to save the ymm registers
+	int osxsave = (info[2] & (1 << 27)) != 0;
+	__cpuidex(info, 7, 0);
+	if (osxsave && (info[1] & (1 << 5)) && (_xgetbv(0) & 6) == 6)
+		detected = DSL_SCAN_AVX2;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse2"))
+		detected = DSL_SCAN_SSE2;
+	if (__builtin_cpu_supports("avx2"))
+		detected = DSL_SCAN_AVX2;
+#endif // _MSC_VER
+#endif // DSL_HAS_X86
+
+	level = detected;
+	return level;
+}
+
+/**
+ * @brief Finds the first element whose field equals value.
+ *
+ * @param pBase Pointer to the field of the first element.
+ * @param stride The distance between elements in bytes.
+ * @param count The number of elements.
+ * @param width The size of the field, 4 or 8 bytes.
+ * @param value The value to look for.
+ * @return The index of the match, or count if there is none.
+ */
+static size_t _ScanField(const char *pBase, size_t stride, size_t count, size_t width, int64_t value)
+{
+#ifdef DSL_HAS_X86
+	// gathers address lanes with 32 bit offsets
+	int canGather = stride <= INT32_MAX / 8;
+
+	switch (_GetScanLevel())
+	{
+	case DSL_SCAN_AVX2:
+		if (canGather)
+			return width == 4 ? _ScanAVX2_32(pBase, stride, count, (int32_t)value) : _ScanAVX2_64(pBase, stride, count, value);
+		// fall through
+	case DSL_SCAN_SSE2:
+		return width == 4 ? _ScanSSE2_32(pBase, stride, count, (int32_t)value) : _ScanSSE2_64(pBase, stride, count, value);
+	}
+#endif // DSL_HAS_X86
+
+	return width == 4 ? _ScanScalar32(pBase, stride, count, (int32_t)value) : _ScanScalar64(pBase, stride, count, value);
+}
+
+/**
+ * @brief Loads a 32 bit field of any element type.
+ *
+ * The fields hold pointers or keys of the caller's type, so they are copied out instead of
+ * being read through an int32_t pointer, which would break strict aliasing. Compilers turn
+ * the copy into a single load.
+ */
+static int32_t _LoadField32(const char *pField)
+{
+	int32_t value;
+	memcpy(&value, pField, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Loads a 64 bit field of any element type, see _LoadField32.
+ */
+static int64_t _LoadField64(const char *pField)
+{
+	int64_t value;
+	memcpy(&value, pField, sizeof(value));
+	return value;
+}
+
+/**
+ * @brief Portable scan of a 32 bit field, four elements per iteration.
+ */
+static size_t _ScanScalar32(const char *pBase, size_t stride, size_t count, int32_t value)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		// the four loads don't depend on each other, unlike a pNext chain
+		int hit0 = _LoadField32(pBase + (i * stride)) == value;
+		int hit1 = _LoadField32(pBase + ((i + 1) * stride)) == value;
+		int hit2 = _LoadField32(pBase + ((i + 2) * stride)) == value;
+		int hit3 = _LoadField32(pBase + ((i + 3) * stride)) == value;
+		if (hit0 | hit1 | hit2 | hit3)
+			return i + (hit0 ? 0 : hit1 ? 1 : hit2 ? 2 : 3);
+	}
+
+	for (; i < count; i++)
+	{
+		if (_LoadField32(pBase + (i * stride)) == value)
+			return i;
+	}
+
+	return count;
+}
+
+/**
+ * @brief Portable scan of a 64 bit field, four elements per iteration.
+ */
+static size_t _ScanScalar64(const char *pBase, size_t stride, size_t count, int64_t value)
+{
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		int hit0 = _LoadField64(pBase + (i * stride)) == value;
+		int hit1 = _LoadField64(pBase + ((i + 1) * stride)) == value;
+		int hit2 = _LoadField64(pBase + ((i + 2) * stride)) == value;
+		int hit3 = _LoadField64(pBase + ((i + 3) * stride)) == value;
+		if (hit0 | hit1 | hit2 | hit3)
+			return i + (hit0 ? 0 : hit1 ? 1 : hit2 ? 2 : 3);
+	}
+
+	for (; i < count; i++)
+	{
+		if (_LoadField64(pBase + (i * stride)) == value)
+			return i;
+	}
+
+	return count;
+}
+
+#ifdef DSL_HAS_X86
+
+/**
+ * @brief Counts the trailing zero bits of a non-zero compare mask.
+ */
+static unsigned int _FirstSetBit(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return index;
+#else
+	return (unsigned int)__builtin_ctz(mask);
+#endif // _MSC_VER
+}
+
+/**
+ * @brief SSE2 scan of a 32 bit field, contiguous fields are loaded a vector at a time.
+ */
+static size_t _ScanSSE2_32(const char *pBase, size_t stride, size_t count, int32_t value)
+{
+	const __m128i needle = _mm_set1_epi32(value);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i lanes;
+		if (stride == sizeof(int32_t))
+		{
+			lanes = _mm_loadu_si128((const __m128i *)(pBase + (i * stride)));
+		}
+		else
+		{
+			lanes = _mm_set_epi32(_LoadField32(pBase + ((i + 3) * stride)),
+								  _LoadField32(pBase + ((i + 2) * stride)),
+								  _LoadField32(pBase + ((i + 1) * stride)),
+								  _LoadField32(pBase + (i * stride)));
+		}
+
+		unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, needle)));
+		if (mask)
+			return i + _FirstSetBit(mask);
+	}
+
+	return i + _ScanScalar32(pBase + (i * stride), stride, count - i, value);
+}
+
+/**
+ * @brief SSE2 scan of a 64 bit field, two elements per compare.
+ */
+static size_t _ScanSSE2_64(const char *pBase, size_t stride, size_t count, int64_t value)
+{
+	// SSE2 has no 64 bit compare, both 32 bit halves have to match
+	const __m128i needle = _mm_set1_epi64x(value);
+	size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		__m128i lanes;
+		if (stride == sizeof(int64_t))
+		{
+			lanes = _mm_loadu_si128((const __m128i *)(pBase + (i * stride)));
+		}
+		else
+		{
+			lanes = _mm_set_epi64x(_LoadField64(pBase + ((i + 1) * stride)),
+								   _LoadField64(pBase + (i * stride)));
+		}
+
+		unsigned int mask = (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, needle)));
+		if ((mask & 3) == 3)
+			return i;
+		if ((mask & 12) == 12)
+			return i + 1;
+	}
+
+	return i + _ScanScalar64(pBase + (i * stride), stride, count - i, value);
+}
+
+/**
+ * @brief AVX2 scan of a 32 bit field, eight elements per compare.
+ */
+DSL_TARGET_AVX2 static size_t _ScanAVX2_32(const char *pBase, size_t stride, size_t count, int32_t value)
+{
+	const __m256i needle = _mm256_set1_epi32(value);
+	const int s = (int)stride;
+	const __m256i offsets = _mm256_setr_epi32(0, s, 2 * s, 3 * s, 4 * s, 5 * s, 6 * s, 7 * s);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		const char *pBlock = pBase + (i * stride);
+		__m256i lanes = stride == sizeof(int32_t)
+							? _mm256_loadu_si256((const __m256i *)pBlock)
+							: _mm256_i32gather_epi32((const int *)pBlock, offsets, 1);
+
+		unsigned int mask = (unsigned int)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lanes, needle)));
+		if (mask)
+			return i + _FirstSetBit(mask);
+	}
+
+	return i + _ScanScalar32(pBase + (i * stride), stride, count - i, value);
+}
+
+/**
+ * @brief AVX2 scan of a 64 bit field, four elements per compare.
+ */
+DSL_TARGET_AVX2 static size_t _ScanAVX2_64(const char *pBase, size_t stride, size_t count, int64_t value)
+{
+	const __m256i needle = _mm256_set1_epi64x(value);
+	const int s = (int)stride;
+	const __m128i offsets = _mm_setr_epi32(0, s, 2 * s, 3 * s);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4)
+	{
+		const char *pBlock = pBase + (i * stride);
+		__m256i lanes = stride == sizeof(int64_t)
+							? _mm256_loadu_si256((const __m256i *)pBlock)
+							: _mm256_i32gather_epi64((const long long *)pBlock, offsets, 1);
+
+		unsigned int mask = (unsigned int)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(lanes, needle)));
+		if (mask)
+			return i + _FirstSetBit(mask);
+	}
+
+	return i + _ScanScalar64(pBase + (i * stride), stride, count - i, value);
+}
+
+#endif // DSL_HAS_X86
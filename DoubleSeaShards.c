@@ -0,0 +1,425 @@
+#include "pch.h"
+#include <malloc.h>
+#include "DoubleSeaShards.h"
+#include "DoubleSeaInline.h"
+#include "DoubleSeaPlatform.h"
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief DSL_Shard is one independently locked sub-list of a DSL_ShardedList.
+ *
+ * The padding keeps the locks of neighbouring shards off each other's cache lines.
+ */
+typedef struct DSL_Shard
+{
+	DSL_Mutex lock;
+	DSL_List list;
+	char padding[DSL_CACHE_LINE_SIZE];
+} DSL_Shard;
+
+/**
+ * @brief DSL_MergeCursor is a shard's position in a k-way merge.
+ */
+typedef struct DSL_MergeCursor
+{
+	void *pNode;
+	size_t shard;
+} DSL_MergeCursor;
+
+// __________________________ Prototypes __________________________
+
+static void _LockAllShards(DSL_ShardedList *pList);
+static void _UnlockAllShards(DSL_ShardedList *pList);
+static size_t _BuildMergeHeap(DSL_ShardedList *pList);
+static void _SiftDown(DSL_ShardedList *pList, DSL_MergeCursor *pHeap, size_t count, size_t i);
+static int _CursorLess(DSL_ShardedList *pList, DSL_MergeCursor *pA, DSL_MergeCursor *pB);
+
+// __________________________ Functions __________________________
+
+/**
+ * @brief DSL_InitShardedList initializes a sharded list
+ *
+ * @param pList - A pointer to the sharded list that will be initialized
+ * @param shardCount - The number of shards, usually the number of inserting threads
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param pShardFunction - A function that hashes a node's key, or NULL to shard by thread
+ * @return int - 1 on success, 0 if the order function is NULL or the shards could not be allocated
+ */
+int DSL_InitShardedList(DSL_ShardedList *pList, size_t shardCount, size_t offset,
+						OrderFunction pOrderFunction, ShardFunction pShardFunction)
+{
+	if (!pList || shardCount == 0 || !pOrderFunction)
+	{
+		return 0;
+	}
+
+	DSL_Shard *pShards = malloc(shardCount * sizeof(DSL_Shard));
+	DSL_MergeCursor *pMergeHeap = malloc(shardCount * sizeof(DSL_MergeCursor));
+	DSL_List **ppMergeLists = malloc(shardCount * sizeof(DSL_List *));
+	if (!pShards || !pMergeHeap || !ppMergeLists)
+	{
+		free(pShards);
+		free(pMergeHeap);
+		free(ppMergeLists);
+		return 0;
+	}
+
+	pList->pShards = pShards;
+	pList->shardCount = shardCount;
+	pList->offset = offset == -1 ? OFFSETOF_DSL_NODE : offset;
+	pList->orderFunction = pOrderFunction;
+	pList->shardFunction = pShardFunction;
+	pList->pMergeHeap = pMergeHeap;
+	pList->ppMergeLists = ppMergeLists;
+
+	for (size_t i = 0; i < shardCount; i++)
+	{
+		DSL_InitMutex(&pShards[i].lock);
+		DSL_InitList(0, pList->offset, &pShards[i].list, pOrderFunction);
+	}
+
+	return 1;
+}
+
+/**
+ * @brief DSL_DestroyShardedList destroys a sharded list
+ *
+ * Destroys every shard with DSL_DestroyListEx and releases the shard storage. No other
+ * thread may be using the list.
+ *
+ * @param pList - A pointer to the sharded list that will be destroyed
+ * @param pDestructor - A function that releases each node, or NULL
+ * @param pCtx - A context pointer that is passed to the destructor
+ */
+void DSL_DestroyShardedList(DSL_ShardedList *pList, DestructorFunction pDestructor, void *pCtx)
+{
+	if (!pList || !pList->pShards)
+	{
+		return;
+	}
+
+	DSL_Shard *pShards = pList->pShards;
+	for (size_t i = 0; i < pList->shardCount; i++)
+	{
+		DSL_DestroyListEx(&pShards[i].list, pDestructor, pCtx);
+		DSL_DestroyMutex(&pShards[i].lock);
+	}
+
+	free(pShards);
+	free(pList->pMergeHeap);
+	free(pList->ppMergeLists);
+	pList->pShards = NULL;
+	pList->pMergeHeap = NULL;
+	pList->ppMergeLists = NULL;
+	pList->shardCount = 0;
+}
+
+/**
+ * @brief DSL_ShardOf returns the shard a node is inserted into by the calling thread
+ *
+ * @param pList - A pointer to the sharded list
+ * @param pNode - A pointer to the node
+ * @return size_t - The shard index
+ */
+size_t DSL_ShardOf(DSL_ShardedList *pList, void *pNode)
+{
+	if (!pList || pList->shardCount == 0)
+	{
+		return 0;
+	}
+
+	size_t hash = pList->shardFunction ? pList->shardFunction(pNode) : DSL_CurrentThreadId();
+
+	// spread the hash so thread ids and small keys don't all land on the same few shards
+	hash ^= hash >> 15;
+	hash *= (size_t)0x9E3779B97F4A7C15ull;
+	hash ^= hash >> 29;
+
+	return hash % pList->shardCount;
+}
+
+/**
+ * @brief DSL_ShardedInsert inserts a node into its shard
+ *
+ * Locks only the node's shard and calls DSL_InsertNode on it.
+ *
+ * @param pNode - A pointer to the node that will be inserted
+ * @param pIntoList - A pointer to the sharded list
+ * @return size_t - The shard the node went into, needed to remove it again
+ */
+size_t DSL_ShardedInsert(void *pNode, DSL_ShardedList *pIntoList)
+{
+	if (!pIntoList || !pNode)
+	{
+		return 0;
+	}
+
+	size_t shard = DSL_ShardOf(pIntoList, pNode);
+	DSL_Shard *pShard = &((DSL_Shard *)pIntoList->pShards)[shard];
+
+	DSL_LockMutex(&pShard->lock);
+	DSL_InsertNode(pNode, &pShard->list);
+	DSL_UnlockMutex(&pShard->lock);
+
+	return shard;
+}
+
+/**
+ * @brief DSL_ShardedRemove removes a node from its shard
+ *
+ * Locks only the given shard and calls DSL_RemoveNode on it.
+ *
+ * @param pNode - A pointer to the node that will be removed
+ * @param pFromList - A pointer to the sharded list
+ * @param shard - The shard returned by DSL_ShardedInsert or DSL_ShardOf
+ */
+void DSL_ShardedRemove(void *pNode, DSL_ShardedList *pFromList, size_t shard)
+{
+	if (!pFromList || !pNode || shard >= pFromList->shardCount)
+	{
+		return;
+	}
+
+	DSL_Shard *pShard = &((DSL_Shard *)pFromList->pShards)[shard];
+
+	DSL_LockMutex(&pShard->lock);
+	DSL_RemoveNode(pNode, &pShard->list);
+	DSL_UnlockMutex(&pShard->lock);
+}
+
+/**
+ * @brief DSL_ShardedLength returns the number of nodes across all shards
+ *
+ * The shards are not locked, so the value is a snapshot.
+ *
+ * @param pList - A pointer to the sharded list
+ * @return size_t - The number of nodes
+ */
+size_t DSL_ShardedLength(DSL_ShardedList *pList)
+{
+	if (!pList)
+	{
+		return 0;
+	}
+
+	size_t length = 0;
+	DSL_Shard *pShards = pList->pShards;
+	for (size_t i = 0; i < pList->shardCount; i++)
+	{
+		length += pShards[i].list.length;
+	}
+
+	return length;
+}
+
+/**
+ * @brief DSL_ShardedForEach visits every node in global order
+ *
+ * Locks all shards and walks them with a k-way merge, so the cost is O(n log k).
+ * The visitor must not modify the sharded list.
+ *
+ * @param pList - A pointer to the sharded list
+ * @param pVisit - A function that is called for each node until it returns 0
+ * @param pCtx - A context pointer that is passed to the visitor
+ */
+void DSL_ShardedForEach(DSL_ShardedList *pList, VisitFunction pVisit, void *pCtx)
+{
+	if (!pList || !pVisit)
+	{
+		return;
+	}
+
+	_LockAllShards(pList);
+
+	DSL_MergeCursor *pHeap = pList->pMergeHeap;
+	size_t count = _BuildMergeHeap(pList);
+
+	while (count > 0)
+	{
+		void *pNode = pHeap[0].pNode;
+		if (!pVisit(pNode, pCtx))
+		{
+			break;
+		}
+
+		// advance the winning shard, or retire it when it runs out
+		pHeap[0].pNode = *DSL_NextPointer(pNode, pList->offset);
+		if (pHeap[0].pNode == NULL)
+		{
+			pHeap[0] = pHeap[--count];
+		}
+		_SiftDown(pList, pHeap, count, 0);
+	}
+
+	_UnlockAllShards(pList);
+}
+
+/**
+ * @brief DSL_ShardedDrain moves every node into a list in global order
+ *
+ * Locks all shards and merges their nodes into pIntoList with DSL_MergeK, leaving the shards
+ * empty. No memory is allocated. pIntoList must use the same offset. An ordered pIntoList
+ * takes part in the merge, so its own nodes stay in order, and it must use the shards' order
+ * function. When pIntoList has deferred ordering enabled or no order function, the merged
+ * nodes are appended to its tail instead, and marked pending if ordering is deferred.
+ *
+ * @param pList - A pointer to the sharded list that will be drained
+ * @param pIntoList - A pointer to the list that receives the nodes
+ * @return size_t - The number of nodes moved
+ */
+size_t DSL_ShardedDrain(DSL_ShardedList *pList, DSL_List *pIntoList)
+{
+	if (!pList || !pIntoList || pIntoList->offset != pList->offset)
+	{
+		return 0;
+	}
+
+	_LockAllShards(pList);
+
+	DSL_List **ppShardLists = pList->ppMergeLists;
+	DSL_Shard *pShards = pList->pShards;
+	for (size_t i = 0; i < pList->shardCount; i++)
+	{
+		ppShardLists[i] = &pShards[i].list;
+	}
+
+	// an ordered destination is merged with the shards, its own nodes included
+	if (pIntoList->orderFunction && !pIntoList->deferredOrder)
+	{
+		size_t moved = DSL_MergeK(ppShardLists, pList->shardCount, pIntoList);
+		_UnlockAllShards(pList);
+		return moved;
+	}
+
+	DSL_List merged;
+	DSL_InitList(0, pList->offset, &merged, pList->orderFunction);
+	size_t moved = DSL_MergeK(ppShardLists, pList->shardCount, &merged);
+
+	// splice the merged nodes onto the tail of the destination
+	if (moved > 0)
+	{
+		*DSL_PrevPointer(merged.pHead, pList->offset) = pIntoList->pTail;
+		if (pIntoList->pTail)
+			*DSL_NextPointer(pIntoList->pTail, pList->offset) = merged.pHead;
+		else
+			pIntoList->pHead = merged.pHead;
+		pIntoList->pTail = merged.pTail;
+		pIntoList->length += moved;
+
+		// a pending segment already runs to the tail, otherwise the new nodes start one
+		if (pIntoList->deferredOrder && !pIntoList->pPending)
+			pIntoList->pPending = merged.pHead;
+
+		// the nodes were linked in by hand, so the destination's filter has to catch up
+		DSL_RebuildFilter(pIntoList);
+	}
+
+	_UnlockAllShards(pList);
+	return moved;
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Locks every shard in index order.
+ *
+ * @param pList Pointer to the sharded list.
+ */
+static void _LockAllShards(DSL_ShardedList *pList)
+{
+	DSL_Shard *pShards = pList->pShards;
+	for (size_t i = 0; i < pList->shardCount; i++)
+	{
+		DSL_LockMutex(&pShards[i].lock);
+	}
+}
+
+/**
+ * @brief Unlocks every shard.
+ *
+ * @param pList Pointer to the sharded list.
+ */
+static void _UnlockAllShards(DSL_ShardedList *pList)
+{
+	DSL_Shard *pShards = pList->pShards;
+	for (size_t i = pList->shardCount; i > 0; i--)
+	{
+		DSL_UnlockMutex(&pShards[i - 1].lock);
+	}
+}
+
+/**
+ * @brief Fills the merge heap with the head of every non-empty shard.
+ *
+ * @param pList Pointer to the sharded list, all shards must be locked.
+ * @return The number of cursors in the heap.
+ */
+static size_t _BuildMergeHeap(DSL_ShardedList *pList)
+{
+	DSL_MergeCursor *pHeap = pList->pMergeHeap;
+	DSL_Shard *pShards = pList->pShards;
+	size_t count = 0;
+
+	for (size_t i = 0; i < pList->shardCount; i++)
+	{
+		if (pShards[i].list.pHead)
+		{
+			pHeap[count].pNode = pShards[i].list.pHead;
+			pHeap[count].shard = i;
+			count++;
+		}
+	}
+
+	for (size_t i = count / 2; i > 0; i--)
+	{
+		_SiftDown(pList, pHeap, count, i - 1);
+	}
+
+	return count;
+}
+
+/**
+ * @brief Restores the heap property below a cursor.
+ *
+ * @param pList Pointer to the sharded list.
+ * @param pHeap Pointer to the heap.
+ * @param count The number of cursors in the heap.
+ * @param i The index of the cursor that may be out of place.
+ */
+static void _SiftDown(DSL_ShardedList *pList, DSL_MergeCursor *pHeap, size_t count, size_t i)
+{
+	while (1)
+	{
+		size_t smallest = i;
+		size_t left = (2 * i) + 1;
+		size_t right = left + 1;
+
+		if (left < count && _CursorLess(pList, &pHeap[left], &pHeap[smallest]))
+			smallest = left;
+		if (right < count && _CursorLess(pList, &pHeap[right], &pHeap[smallest]))
+			smallest = right;
+		if (smallest == i)
+			return;
+
+		DSL_MergeCursor swap = pHeap[i];
+		pHeap[i] = pHeap[smallest];
+		pHeap[smallest] = swap;
+		i = smallest;
+	}
+}
+
+/**
+ * @brief Orders two merge cursors, ties go to the lower shard so merges are deterministic.
+ *
+ * @param pList Pointer to the sharded list.
+ * @param pA Pointer to the first cursor.
+ * @param pB Pointer to the second cursor.
+ * @return Non-zero if pA comes before pB.
+ */
+static int _CursorLess(DSL_ShardedList *pList, DSL_MergeCursor *pA, DSL_MergeCursor *pB)
+{
+	int order = pList->orderFunction ? pList->orderFunction(pA->pNode, pB->pNode) : 0;
+	return order < 0 || (order == 0 && pA->shard < pB->shard);
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#ifndef DOUBLE_SEA_SHARDS_H
+#define DOUBLE_SEA_SHARDS_H
+#include "DoubleSeaLib.h"
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief ShardFunction is a function pointer type that is used to pick a node's shard.
+ *
+ * @param pNode The node being inserted.
+ *
+ * @return size_t A hash of the node's key, it is reduced modulo the shard count.
+ */
+typedef size_t (*ShardFunction)(void *pNode);
+
+/**
+ * @brief VisitFunction is a function pointer type that is called for each visited node.
+ *
+ * @param pNode The node being visited.
+ * @param pCtx A caller supplied context pointer.
+ *
+ * @return int Returns non-zero to keep visiting, and 0 to stop.
+ */
+typedef int (*VisitFunction)(void *pNode, void *pCtx);
+
+/**
+ * @brief DSL_ShardedList is an ordered list split across independently locked shards.
+ *
+ * Every shard is an ordinary ordered DSL_List behind its own lock, so inserts on different
+ * shards never contend. Global order is only produced on demand by merging the shards.
+ *
+ * @param pShards A void pointer to the shard storage.
+ * @param shardCount The number of shards.
+ * @param offset The offset to the pNext pointer in the nodes.
+ * @param orderFunction A function pointer to the function that compares two nodes.
+ * @param shardFunction A function pointer to the key hash, or NULL to shard by thread.
+ * @param pMergeHeap A void pointer to the scratch heap used while merging.
+ * @param ppMergeLists A pointer to the scratch array of shard lists used while draining.
+ */
+typedef struct DSL_ShardedList
+{
+	void *pShards;
+	size_t shardCount;
+	size_t offset;
+	OrderFunction orderFunction;
+	ShardFunction shardFunction;
+	void *pMergeHeap;
+	DSL_List **ppMergeLists;
+} DSL_ShardedList;
+
+// __________________________ Function Prototypes __________________________
+
+/**
+ * @brief DSL_InitShardedList initializes a sharded list
+ *
+ * @param pList - A pointer to the sharded list that will be initialized
+ * @param shardCount - The number of shards, usually the number of inserting threads
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param pShardFunction - A function that hashes a node's key, or NULL to shard by thread
+ * @return int - 1 on success, 0 if the order function is NULL or the shards could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_InitShardedList(DSL_ShardedList *pList, size_t shardCount, size_t offset,
+										   OrderFunction pOrderFunction, ShardFunction pShardFunction);
+
+/**
+ * @brief DSL_DestroyShardedList destroys a sharded list
+ *
+ * Destroys every shard with DSL_DestroyListEx and releases the shard storage. No other
+ * thread may be using the list.
+ *
+ * @param pList - A pointer to the sharded list that will be destroyed
+ * @param pDestructor - A function that releases each node, or NULL
+ * @param pCtx - A context pointer that is passed to the destructor
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroyShardedList(DSL_ShardedList *pList, DestructorFunction pDestructor, void *pCtx);
+
+/**
+ * @brief DSL_ShardOf returns the shard a node is inserted into by the calling thread
+ *
+ * @param pList - A pointer to the sharded list
+ * @param pNode - A pointer to the node
+ * @return size_t - The shard index
+ */
+DOUBLE_SEA_LIB_API size_t DSL_ShardOf(DSL_ShardedList *pList, void *pNode);
+
+/**
+ * @brief DSL_ShardedInsert inserts a node into its shard
+ *
+ * Locks only the node's shard and calls DSL_InsertNode on it.
+ *
+ * @param pNode - A pointer to the node that will be inserted
+ * @param pIntoList - A pointer to the sharded list
+ * @return size_t - The shard the node went into, needed to remove it again
+ */
+DOUBLE_SEA_LIB_API size_t DSL_ShardedInsert(void *pNode, DSL_ShardedList *pIntoList);
+
+/**
+ * @brief DSL_ShardedRemove removes a node from its shard
+ *
+ * Locks only the given shard and calls DSL_RemoveNode on it.
+ *
+ * @param pNode - A pointer to the node that will be removed
+ * @param pFromList - A pointer to the sharded list
+ * @param shard - The shard returned by DSL_ShardedInsert or DSL_ShardOf
+ */
+DOUBLE_SEA_LIB_API void DSL_ShardedRemove(void *pNode, DSL_ShardedList *pFromList, size_t shard);
+
+/**
+ * @brief DSL_ShardedLength returns the number of nodes across all shards
+ *
+ * The shards are not locked, so the value is a snapshot.
+ *
+ * @param pList - A pointer to the sharded list
+ * @return size_t - The number of nodes
+ */
+DOUBLE_SEA_LIB_API size_t DSL_ShardedLength(DSL_ShardedList *pList);
+
+/**
+ * @brief DSL_ShardedForEach visits every node in global order
+ *
+ * Locks all shards and walks them with a k-way merge, so the cost is O(n log k).
+ * The visitor must not modify the sharded list.
+ *
+ * @param pList - A pointer to the sharded list
+ * @param pVisit - A function that is called for each node until it returns 0
+ * @param pCtx - A context pointer that is passed to the visitor
+ */
+DOUBLE_SEA_LIB_API void DSL_ShardedForEach(DSL_ShardedList *pList, VisitFunction pVisit, void *pCtx);
+
+/**
+ * @brief DSL_ShardedDrain moves every node into a list in global order
+ *
+ * Locks all shards and merges their nodes into pIntoList with DSL_MergeK, leaving the shards
+ * empty. No memory is allocated. pIntoList must use the same offset. An ordered pIntoList
+ * takes part in the merge, so its own nodes stay in order, and it must use the shards' order
+ * function. When pIntoList has deferred ordering enabled or no order function, the merged
+ * nodes are appended to its tail instead, and marked pending if ordering is deferred.
+ *
+ * @param pList - A pointer to the sharded list that will be drained
+ * @param pIntoList - A pointer to the list that receives the nodes
+ * @return size_t - The number of nodes moved
+ */
+DOUBLE_SEA_LIB_API size_t DSL_ShardedDrain(DSL_ShardedList *pList, DSL_List *pIntoList);
+
+#endif // DOUBLE_SEA_SHARDS_H
@@ -0,0 +1,721 @@
+#include "pch.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <string.h>
+#include "DoubleSeaSpill.h"
+#include "DoubleSeaInline.h"
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief DSL_SpillRun is one sorted run written to a temporary file.
+ *
+ * Each record is the payload size as a size_t followed by the payload.
+ *
+ * @param pFile The temporary file.
+ * @param remaining The number of records that have not been read yet.
+ * @param pHead The node read from the run most recently.
+ * @param age The order the run was written in, equal nodes from older runs come first.
+ * @param mark The file position saved before a merge, so a failed merge can be undone.
+ * @param markRemaining The number of records that had not been read before a merge.
+ * @param pMarkHead The head node before a merge, NULL while no merge is in progress.
+ */
+typedef struct DSL_SpillRun
+{
+	FILE *pFile;
+	size_t remaining;
+	void *pHead;
+	size_t age;
+	fpos_t mark;
+	size_t markRemaining;
+	void *pMarkHead;
+} DSL_SpillRun;
+
+// __________________________ Prototypes __________________________
+
+static int _SpillResident(DSL_SpillList *pList);
+static int _MergeRuns(DSL_SpillList *pList);
+static void _RestoreRuns(DSL_SpillList *pList, size_t first);
+static void _RebuildHeap(DSL_SpillList *pList);
+static void _ReleaseRun(DSL_SpillList *pList, DSL_SpillRun *pRun);
+static size_t _RunSize(DSL_SpillRun *pRun);
+static int _ReserveRun(DSL_SpillList *pList);
+static FILE *_OpenRunFile(void);
+static int _ReserveBuffer(DSL_SpillList *pList, size_t size);
+static int _WriteRecord(DSL_SpillList *pList, FILE *pFile, void *pNode);
+static int _ReadRunHead(DSL_SpillList *pList, DSL_SpillRun *pRun);
+static int _RunLess(DSL_SpillList *pList, DSL_SpillRun *pA, DSL_SpillRun *pB);
+static void _SiftRunUp(DSL_SpillList *pList, size_t i);
+static void _SiftRunDown(DSL_SpillList *pList, size_t i);
+
+// __________________________ Functions __________________________
+
+/**
+ * @brief DSL_InitSpillList initializes a spill list
+ *
+ * @param pList - A pointer to the spill list that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param maxResident - The number of nodes kept in memory before they are spilled to disk
+ * @param pSerialize - A function that writes a node's payload
+ * @param pDeserialize - A function that rebuilds a node from its payload
+ * @param pDestructor - A function that releases a node once it has been written, or NULL
+ * @param pCtx - A context pointer that is passed to the three functions
+ * @return int - 1 on success, 0 if an argument is invalid
+ */
+int DSL_InitSpillList(DSL_SpillList *pList, size_t offset, OrderFunction pOrderFunction, size_t maxResident,
+					  SerializeFunction pSerialize, DeserializeFunction pDeserialize,
+					  DestructorFunction pDestructor, void *pCtx)
+{
+	if (!pList || !pOrderFunction || !pSerialize || !pDeserialize || maxResident == 0)
+	{
+		return 0;
+	}
+
+	DSL_InitList(0, offset, &pList->resident, pOrderFunction);
+	DSL_SetDeferredOrder(&pList->resident, 1);
+	pList->maxResident = maxResident;
+	pList->maxOpenRuns = DSL_SPILL_MAX_OPEN_RUNS;
+	pList->serialize = pSerialize;
+	pList->deserialize = pDeserialize;
+	pList->destructor = pDestructor;
+	pList->pCtx = pCtx;
+	pList->pRuns = NULL;
+	pList->runCount = 0;
+	pList->runCapacity = 0;
+	pList->pMergeHeap = NULL;
+	pList->heapCount = 0;
+	pList->pBuffer = NULL;
+	pList->bufferSize = 0;
+	pList->length = 0;
+	pList->ioError = 0;
+	pList->runsWritten = 0;
+	return 1;
+}
+
+/**
+ * @brief DSL_DestroySpillList destroys a spill list
+ *
+ * Releases the resident nodes and the head node of every run with the destructor, and
+ * closes the temporary files, which deletes them.
+ *
+ * @param pList - A pointer to the spill list that will be destroyed
+ */
+void DSL_DestroySpillList(DSL_SpillList *pList)
+{
+	if (!pList)
+	{
+		return;
+	}
+
+	DSL_DestroyListEx(&pList->resident, pList->destructor, pList->pCtx);
+
+	DSL_SpillRun **ppRuns = pList->pRuns;
+	for (size_t i = 0; i < pList->runCount; i++)
+	{
+		if (pList->destructor)
+			pList->destructor(ppRuns[i]->pHead, pList->pCtx);
+		fclose(ppRuns[i]->pFile);
+		free(ppRuns[i]);
+	}
+
+	free(pList->pRuns);
+	free(pList->pMergeHeap);
+	free(pList->pBuffer);
+	pList->pRuns = NULL;
+	pList->runCount = 0;
+	pList->runCapacity = 0;
+	pList->pMergeHeap = NULL;
+	pList->heapCount = 0;
+	pList->pBuffer = NULL;
+	pList->bufferSize = 0;
+	pList->length = 0;
+}
+
+/**
+ * @brief DSL_SpillInsert inserts a node into a spill list
+ *
+ * Appends the node to the resident list in O(1). When the resident list already holds
+ * maxResident nodes it is first sorted, written to a new run with buffered sequential writes,
+ * and released. The nodes are only released once the whole run has been written, flushed and
+ * read back. If the spill fails they stay resident and the node is not inserted, so memory
+ * stays bounded by maxResident. Once maxOpenRuns runs are open, the newest runs of similar
+ * size are merged into one first. Nodes can still be inserted while the list is being popped.
+ *
+ * @param pNode - A pointer to the node that will be inserted
+ * @param pIntoList - A pointer to the spill list
+ * @return int - 1 on success, 0 if the resident nodes could not be spilled and the node was
+ * 				 not inserted
+ */
+int DSL_SpillInsert(void *pNode, DSL_SpillList *pIntoList)
+{
+	if (!pIntoList || !pNode)
+	{
+		return 0;
+	}
+
+	if (pIntoList->resident.length >= pIntoList->maxResident && !_SpillResident(pIntoList))
+	{
+		return 0;
+	}
+
+	DSL_InsertNode(pNode, &pIntoList->resident);
+	pIntoList->length++;
+	return 1;
+}
+
+/**
+ * @brief DSL_SpillPeek returns the node the next DSL_SpillPop will return
+ *
+ * @param pList - A pointer to the spill list
+ * @return void* - A pointer to the first node in order, or NULL if the list is empty
+ */
+void *DSL_SpillPeek(DSL_SpillList *pList)
+{
+	if (!pList || pList->length == 0)
+	{
+		return NULL;
+	}
+
+	DSL_SettleOrder(&pList->resident);
+	void *pResident = pList->resident.pHead;
+	if (pList->heapCount == 0)
+	{
+		return pResident;
+	}
+
+	// runs hold older nodes, so they win ties to keep equal nodes in insertion order
+	DSL_SpillRun *pRun = ((DSL_SpillRun **)pList->pMergeHeap)[0];
+	if (!pResident || pList->resident.orderFunction(pRun->pHead, pResident) <= 0)
+	{
+		return pRun->pHead;
+	}
+
+	return pResident;
+}
+
+/**
+ * @brief DSL_SpillPop removes the first node in order from a spill list and returns it
+ *
+ * Works like DSL_Pop across the resident list and every run, so popping until NULL streams
+ * the whole list in order. Nodes read back from a run were created by the DeserializeFunction
+ * and belong to the caller, as do popped resident nodes. A run's file is closed as soon as
+ * its last node has been popped.
+ *
+ * @param pFromList - A pointer to the spill list
+ * @return void* - A pointer to the removed node, or NULL once the list is empty
+ */
+void *DSL_SpillPop(DSL_SpillList *pFromList)
+{
+	void *pNode = DSL_SpillPeek(pFromList);
+	if (!pNode)
+	{
+		return NULL;
+	}
+
+	if (pNode == pFromList->resident.pHead)
+	{
+		DSL_Pop(&pFromList->resident);
+	}
+	else
+	{
+		// replace the winning run's head with its next record
+		DSL_SpillRun **ppHeap = pFromList->pMergeHeap;
+		DSL_SpillRun *pRun = ppHeap[0];
+		if (!_ReadRunHead(pFromList, pRun))
+		{
+			// whatever is left of the run can't be read back
+			pFromList->ioError = 1;
+			pFromList->length -= pRun->remaining;
+			pRun->remaining = 0;
+		}
+
+		if (!pRun->pHead)
+		{
+			ppHeap[0] = ppHeap[--pFromList->heapCount];
+			_ReleaseRun(pFromList, pRun);
+		}
+		_SiftRunDown(pFromList, 0);
+	}
+
+	pFromList->length--;
+	return pNode;
+}
+
+/**
+ * @brief DSL_SpillLength returns the number of nodes in memory and on disk
+ *
+ * @param pList - A pointer to the spill list
+ * @return size_t - The number of nodes
+ */
+size_t DSL_SpillLength(DSL_SpillList *pList)
+{
+	return pList ? pList->length : 0;
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Sorts the resident list, writes it to a new run and releases its nodes.
+ *
+ * The nodes stay resident until the run has been written, flushed and its first record read
+ * back, so a failed spill leaves the list as it was.
+ *
+ * @param pList Pointer to the spill list.
+ * @return 1 on success, 0 if the run could not be created or written.
+ */
+static int _SpillResident(DSL_SpillList *pList)
+{
+	if (pList->runCount >= pList->maxOpenRuns && !_MergeRuns(pList))
+	{
+		return 0;
+	}
+
+	DSL_SpillRun *pRun = _ReserveRun(pList) ? malloc(sizeof(DSL_SpillRun)) : NULL;
+	if (!pRun)
+	{
+		return 0;
+	}
+
+	FILE *pFile = _OpenRunFile();
+	if (!pFile)
+	{
+		pList->ioError = 1;
+		free(pRun);
+		return 0;
+	}
+	setvbuf(pFile, NULL, _IOFBF, DSL_SPILL_BUFFER_SIZE);
+
+	DSL_SettleOrder(&pList->resident);
+	size_t offset = pList->resident.offset;
+	int failed = 0;
+	for (void *pNode = pList->resident.pHead; pNode; pNode = *DSL_NextPointer(pNode, offset))
+	{
+		if (!_WriteRecord(pList, pFile, pNode))
+		{
+			failed = 1;
+			break;
+		}
+	}
+
+	pRun->pFile = pFile;
+	pRun->remaining = pList->resident.length;
+	pRun->pHead = NULL;
+	pRun->age = pList->runsWritten;
+	pRun->pMarkHead = NULL;
+
+	if (failed || fflush(pFile) != 0 || fseek(pFile, 0, SEEK_SET) != 0 || !_ReadRunHead(pList, pRun))
+	{
+		pList->ioError = 1;
+		fclose(pFile);
+		free(pRun);
+		return 0;
+	}
+
+	void *pNode;
+	while ((pNode = DSL_Pop(&pList->resident)) != NULL)
+	{
+		if (pList->destructor)
+			pList->destructor(pNode, pList->pCtx);
+	}
+
+	((DSL_SpillRun **)pList->pRuns)[pList->runCount++] = pRun;
+	((DSL_SpillRun **)pList->pMergeHeap)[pList->heapCount] = pRun;
+	_SiftRunUp(pList, pList->heapCount++);
+	pList->runsWritten++;
+	return 1;
+}
+
+/**
+ * @brief Merges the newest runs of similar size into one run.
+ *
+ * Starting from the newest run, older runs are added while they are no larger than the runs
+ * picked so far, so a large old run is only rewritten once enough newer data has built up to
+ * match it. While maxOpenRuns covers the size tiers, every record is rewritten O(log n) times.
+ * Only runs adjacent in age are merged, which keeps equal nodes in insertion order.
+ *
+ * Each run's position is saved first and the first head of every run is kept until the merged
+ * run is complete, so a failed merge can be undone without losing records. The nodes read back
+ * during the merge are released with the destructor, which is therefore required.
+ *
+ * @param pList Pointer to the spill list.
+ * @return 1 on success, 0 if the runs could not be merged, they are left as they were.
+ */
+static int _MergeRuns(DSL_SpillList *pList)
+{
+	if (pList->runCount < 2)
+	{
+		return 1;
+	}
+
+	if (!pList->destructor)
+	{
+		return 0;
+	}
+
+	DSL_SpillRun **ppRuns = pList->pRuns;
+	size_t first = pList->runCount - 1;
+	size_t total = _RunSize(ppRuns[first]);
+	while (first > 0 && (pList->runCount - first < 2 || _RunSize(ppRuns[first - 1]) <= total))
+	{
+		first--;
+		total += _RunSize(ppRuns[first]);
+	}
+
+	for (size_t i = first; i < pList->runCount; i++)
+	{
+		DSL_SpillRun *pRun = ppRuns[i];
+		if (fgetpos(pRun->pFile, &pRun->mark) != 0)
+		{
+			for (size_t j = first; j < i; j++)
+				ppRuns[j]->pMarkHead = NULL;
+			pList->ioError = 1;
+			return 0;
+		}
+		pRun->markRemaining = pRun->remaining;
+		pRun->pMarkHead = pRun->pHead;
+	}
+
+	DSL_SpillRun *pMerged = malloc(sizeof(DSL_SpillRun));
+	FILE *pFile = pMerged ? _OpenRunFile() : NULL;
+	if (!pFile)
+	{
+		free(pMerged);
+		_RestoreRuns(pList, first);
+		return 0;
+	}
+	setvbuf(pFile, NULL, _IOFBF, DSL_SPILL_BUFFER_SIZE);
+
+	// the heap only holds the runs being merged while the merge runs
+	DSL_SpillRun **ppHeap = pList->pMergeHeap;
+	pList->heapCount = 0;
+	for (size_t i = first; i < pList->runCount; i++)
+	{
+		ppHeap[pList->heapCount] = ppRuns[i];
+		_SiftRunUp(pList, pList->heapCount++);
+	}
+
+	size_t written = 0;
+	int failed = 0;
+	while (pList->heapCount > 0)
+	{
+		DSL_SpillRun *pRun = ppHeap[0];
+		void *pNode = pRun->pHead;
+		if (!_WriteRecord(pList, pFile, pNode))
+		{
+			failed = 1;
+			break;
+		}
+		written++;
+
+		if (pNode != pRun->pMarkHead)
+			pList->destructor(pNode, pList->pCtx);
+		if (!_ReadRunHead(pList, pRun))
+		{
+			failed = 1;
+			break;
+		}
+
+		if (!pRun->pHead)
+			ppHeap[0] = ppHeap[--pList->heapCount];
+		_SiftRunDown(pList, 0);
+	}
+
+	pMerged->pFile = pFile;
+	pMerged->remaining = written;
+	pMerged->pHead = NULL;
+	pMerged->age = ppRuns[first]->age;
+	pMerged->pMarkHead = NULL;
+	if (failed || fflush(pFile) != 0 || fseek(pFile, 0, SEEK_SET) != 0 || !_ReadRunHead(pList, pMerged))
+	{
+		fclose(pFile);
+		free(pMerged);
+		_RestoreRuns(pList, first);
+		return 0;
+	}
+
+	for (size_t i = first; i < pList->runCount; i++)
+	{
+		pList->destructor(ppRuns[i]->pMarkHead, pList->pCtx);
+		fclose(ppRuns[i]->pFile);
+		free(ppRuns[i]);
+	}
+
+	ppRuns[first] = pMerged;
+	pList->runCount = first + 1;
+	_RebuildHeap(pList);
+	return 1;
+}
+
+/**
+ * @brief Undoes a failed merge by rewinding the merged runs to the positions saved before it.
+ *
+ * @param pList Pointer to the spill list.
+ * @param first The index of the oldest run that took part in the merge.
+ */
+static void _RestoreRuns(DSL_SpillList *pList, size_t first)
+{
+	DSL_SpillRun **ppRuns = pList->pRuns;
+	pList->ioError = 1;
+
+	for (size_t i = first; i < pList->runCount; i++)
+	{
+		DSL_SpillRun *pRun = ppRuns[i];
+		if (pRun->pHead && pRun->pHead != pRun->pMarkHead)
+			pList->destructor(pRun->pHead, pList->pCtx);
+		fsetpos(pRun->pFile, &pRun->mark);
+		pRun->remaining = pRun->markRemaining;
+		pRun->pHead = pRun->pMarkHead;
+		pRun->pMarkHead = NULL;
+	}
+
+	_RebuildHeap(pList);
+}
+
+/**
+ * @brief Puts every open run back into the merge heap.
+ *
+ * @param pList Pointer to the spill list.
+ */
+static void _RebuildHeap(DSL_SpillList *pList)
+{
+	DSL_SpillRun **ppRuns = pList->pRuns;
+	DSL_SpillRun **ppHeap = pList->pMergeHeap;
+	pList->heapCount = 0;
+	for (size_t i = 0; i < pList->runCount; i++)
+	{
+		ppHeap[pList->heapCount] = ppRuns[i];
+		_SiftRunUp(pList, pList->heapCount++);
+	}
+}
+
+/**
+ * @brief Closes a drained run and removes it from the run array.
+ *
+ * The run must already be out of the merge heap.
+ *
+ * @param pList Pointer to the spill list.
+ * @param pRun Pointer to the run.
+ */
+static void _ReleaseRun(DSL_SpillList *pList, DSL_SpillRun *pRun)
+{
+	DSL_SpillRun **ppRuns = pList->pRuns;
+	for (size_t i = 0; i < pList->runCount; i++)
+	{
+		if (ppRuns[i] == pRun)
+		{
+			memmove(&ppRuns[i], &ppRuns[i + 1], (pList->runCount - i - 1) * sizeof(DSL_SpillRun *));
+			pList->runCount--;
+			break;
+		}
+	}
+
+	fclose(pRun->pFile);
+	free(pRun);
+}
+
+/**
+ * @brief Counts the nodes a run still holds, its head included.
+ *
+ * @param pRun Pointer to the run.
+ * @return The number of nodes.
+ */
+static size_t _RunSize(DSL_SpillRun *pRun)
+{
+	return pRun->remaining + (pRun->pHead != NULL);
+}
+
+/**
+ * @brief Makes room for one more run in the run array and the merge heap.
+ *
+ * @param pList Pointer to the spill list.
+ * @return 1 on success, 0 if the arrays could not be grown.
+ */
+static int _ReserveRun(DSL_SpillList *pList)
+{
+	if (pList->runCount < pList->runCapacity)
+	{
+		return 1;
+	}
+
+	size_t capacity = pList->runCapacity ? pList->runCapacity * 2 : 8;
+	DSL_SpillRun **ppRuns = realloc(pList->pRuns, capacity * sizeof(DSL_SpillRun *));
+	if (!ppRuns)
+	{
+		return 0;
+	}
+	pList->pRuns = ppRuns;
+
+	DSL_SpillRun **ppHeap = realloc(pList->pMergeHeap, capacity * sizeof(DSL_SpillRun *));
+	if (!ppHeap)
+	{
+		return 0;
+	}
+	pList->pMergeHeap = ppHeap;
+	pList->runCapacity = capacity;
+	return 1;
+}
+
+/**
+ * @brief Creates a temporary file that is deleted when it is closed.
+ *
+ * @return The file, or NULL on failure.
+ */
+static FILE *_OpenRunFile(void)
+{
+#ifdef _MSC_VER
+	FILE *pFile = NULL;
+	return tmpfile_s(&pFile) == 0 ? pFile : NULL;
+#else
+	return tmpfile();
+#endif // _MSC_VER
+}
+
+/**
+ * @brief Grows the payload buffer.
+ *
+ * @param pList Pointer to the spill list.
+ * @param size The number of bytes the buffer has to hold.
+ * @return 1 on success, 0 if the buffer could not be grown.
+ */
+static int _ReserveBuffer(DSL_SpillList *pList, size_t size)
+{
+	if (size <= pList->bufferSize)
+	{
+		return 1;
+	}
+
+	void *pBuffer = realloc(pList->pBuffer, size);
+	if (!pBuffer)
+	{
+		return 0;
+	}
+
+	pList->pBuffer = pBuffer;
+	pList->bufferSize = size;
+	return 1;
+}
+
+/**
+ * @brief Writes one node as a record.
+ *
+ * @param pList Pointer to the spill list.
+ * @param pFile The run file.
+ * @param pNode The node to write.
+ * @return 1 on success, 0 if the payload buffer could not be grown or the write failed.
+ */
+static int _WriteRecord(DSL_SpillList *pList, FILE *pFile, void *pNode)
+{
+	size_t size = pList->serialize(pNode, pList->pBuffer, pList->bufferSize, pList->pCtx);
+	if (size > pList->bufferSize)
+	{
+		if (!_ReserveBuffer(pList, size))
+		{
+			return 0;
+		}
+		pList->serialize(pNode, pList->pBuffer, pList->bufferSize, pList->pCtx);
+	}
+
+	return fwrite(&size, sizeof(size), 1, pFile) == 1 && (size == 0 || fwrite(pList->pBuffer, size, 1, pFile) == 1);
+}
+
+/**
+ * @brief Reads the next record of a run into its head node.
+ *
+ * The head is NULL afterwards when the run is exhausted or the record could not be read.
+ *
+ * @param pList Pointer to the spill list.
+ * @param pRun Pointer to the run.
+ * @return 1 if a node was read or the run is exhausted, 0 if the record could not be read.
+ */
+static int _ReadRunHead(DSL_SpillList *pList, DSL_SpillRun *pRun)
+{
+	pRun->pHead = NULL;
+	if (pRun->remaining == 0)
+	{
+		return 1;
+	}
+
+	size_t size;
+	if (fread(&size, sizeof(size), 1, pRun->pFile) == 1 && _ReserveBuffer(pList, size) &&
+		(size == 0 || fread(pList->pBuffer, size, 1, pRun->pFile) == 1))
+	{
+		pRun->pHead = pList->deserialize(pList->pBuffer, size, pList->pCtx);
+	}
+
+	if (!pRun->pHead)
+	{
+		return 0;
+	}
+
+	*DSL_NextPointer(pRun->pHead, pList->resident.offset) = NULL;
+	*DSL_PrevPointer(pRun->pHead, pList->resident.offset) = NULL;
+	pRun->remaining--;
+	return 1;
+}
+
+/**
+ * @brief Compares the heads of two runs.
+ *
+ * @param pList Pointer to the spill list.
+ * @param pA Pointer to the first run.
+ * @param pB Pointer to the second run.
+ * @return 1 if the first run's head comes first, ties go to the older run.
+ */
+static int _RunLess(DSL_SpillList *pList, DSL_SpillRun *pA, DSL_SpillRun *pB)
+{
+	int order = pList->resident.orderFunction(pA->pHead, pB->pHead);
+	return order < 0 || (order == 0 && pA->age < pB->age);
+}
+
+/**
+ * @brief Moves a run up the merge heap until its parent comes first.
+ *
+ * @param pList Pointer to the spill list.
+ * @param i The heap index of the run.
+ */
+static void _SiftRunUp(DSL_SpillList *pList, size_t i)
+{
+	DSL_SpillRun **ppHeap = pList->pMergeHeap;
+	while (i > 0)
+	{
+		size_t parent = (i - 1) / 2;
+		if (!_RunLess(pList, ppHeap[i], ppHeap[parent]))
+			return;
+
+		DSL_SpillRun *pSwap = ppHeap[i];
+		ppHeap[i] = ppHeap[parent];
+		ppHeap[parent] = pSwap;
+		i = parent;
+	}
+}
+
+/**
+ * @brief Moves a run down the merge heap until both children come after it.
+ *
+ * @param pList Pointer to the spill list.
+ * @param i The heap index of the run.
+ */
+static void _SiftRunDown(DSL_SpillList *pList, size_t i)
+{
+	DSL_SpillRun **ppHeap = pList->pMergeHeap;
+	size_t count = pList->heapCount;
+	while (1)
+	{
+		size_t smallest = i;
+		size_t left = (2 * i) + 1;
+		size_t right = left + 1;
+
+		if (left < count && _RunLess(pList, ppHeap[left], ppHeap[smallest]))
+			smallest = left;
+		if (right < count && _RunLess(pList, ppHeap[right], ppHeap[smallest]))
+			smallest = right;
+		if (smallest == i)
+			return;
+
+		DSL_SpillRun *pSwap = ppHeap[i];
+		ppHeap[i] = ppHeap[smallest];
+		ppHeap[smallest] = pSwap;
+		i = smallest;
+	}
+}
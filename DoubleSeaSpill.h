@@ -0,0 +1,164 @@
+#pragma once
+
+#ifndef DOUBLE_SEA_SPILL_H
+#define DOUBLE_SEA_SPILL_H
+#include "DoubleSeaLib.h"
+
+// __________________________ Macros __________________________
+
+#define DSL_SPILL_BUFFER_SIZE (1 << 20)
+#define DSL_SPILL_MAX_OPEN_RUNS 64 // Default number of runs kept open before they are merged
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief SerializeFunction is a function pointer type that is used to write a node's payload.
+ *
+ * @param pNode The node to write.
+ * @param pBuffer The buffer that receives the payload.
+ * @param bufferSize The size of the buffer in bytes.
+ * @param pCtx A caller supplied context pointer.
+ *
+ * @return size_t The size of the payload in bytes. When it is larger than bufferSize nothing
+ * 		   needs to be written, the function is called again with a large enough buffer.
+ */
+typedef size_t (*SerializeFunction)(void *pNode, void *pBuffer, size_t bufferSize, void *pCtx);
+
+/**
+ * @brief DeserializeFunction is a function pointer type that is used to rebuild a node.
+ *
+ * @param pBuffer The payload written by the SerializeFunction.
+ * @param size The size of the payload in bytes.
+ * @param pCtx A caller supplied context pointer.
+ *
+ * @return void* A new node holding the payload, or NULL if it could not be allocated.
+ */
+typedef void *(*DeserializeFunction)(const void *pBuffer, size_t size, void *pCtx);
+
+/**
+ * @brief DSL_SpillList is an ordered list that keeps only part of its nodes in memory.
+ *
+ * Inserts go into a resident list with deferred ordering. Whenever it holds maxResident
+ * nodes it is sorted and written to a temporary file as one run, and the nodes are released.
+ * Pops merge the resident list with the head of every run, so only one node per run has
+ * to be in memory. Every run keeps its file open until its last node has been popped, so once
+ * maxOpenRuns runs are open the next spill first merges the newest runs of similar size into
+ * one run, so a node is only rewritten once newer runs have caught up with the size of its
+ * run. Merging releases the nodes it reads back with the destructor; without one, spills fail
+ * once maxOpenRuns runs are open.
+ *
+ * @param resident The nodes that are still in memory.
+ * @param maxResident The number of resident nodes that triggers a spill.
+ * @param maxOpenRuns The number of open runs that triggers a merge, at least 2.
+ * @param serialize A function pointer to the function that writes a node's payload.
+ * @param deserialize A function pointer to the function that rebuilds a node.
+ * @param destructor A function pointer to the function that releases a node, or NULL.
+ * @param pCtx A context pointer that is passed to the three functions.
+ * @param pRuns A void pointer to the open runs, oldest first.
+ * @param runCount The number of open runs.
+ * @param runCapacity The number of runs there is room for.
+ * @param pMergeHeap A void pointer to the heap of open runs.
+ * @param heapCount The number of runs in the heap.
+ * @param pBuffer A void pointer to the payload buffer.
+ * @param bufferSize The size of the payload buffer in bytes.
+ * @param length The number of nodes in memory and on disk.
+ * @param ioError Set to 1 once a read or write to a run has failed.
+ * @param runsWritten The number of runs spilled so far, used to order runs by age.
+ */
+typedef struct DSL_SpillList
+{
+	DSL_List resident;
+	size_t maxResident;
+	size_t maxOpenRuns;
+	SerializeFunction serialize;
+	DeserializeFunction deserialize;
+	DestructorFunction destructor;
+	void *pCtx;
+	void *pRuns;
+	size_t runCount;
+	size_t runCapacity;
+	void *pMergeHeap;
+	size_t heapCount;
+	void *pBuffer;
+	size_t bufferSize;
+	size_t length;
+	int ioError;
+	size_t runsWritten;
+} DSL_SpillList;
+
+// __________________________ Function Prototypes __________________________
+
+/**
+ * @brief DSL_InitSpillList initializes a spill list
+ *
+ * @param pList - A pointer to the spill list that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param maxResident - The number of nodes kept in memory before they are spilled to disk
+ * @param pSerialize - A function that writes a node's payload
+ * @param pDeserialize - A function that rebuilds a node from its payload
+ * @param pDestructor - A function that releases a node once it has been written, or NULL
+ * @param pCtx - A context pointer that is passed to the three functions
+ * @return int - 1 on success, 0 if an argument is invalid
+ */
+DOUBLE_SEA_LIB_API int DSL_InitSpillList(DSL_SpillList *pList, size_t offset, OrderFunction pOrderFunction, size_t maxResident,
+										 SerializeFunction pSerialize, DeserializeFunction pDeserialize,
+										 DestructorFunction pDestructor, void *pCtx);
+
+/**
+ * @brief DSL_DestroySpillList destroys a spill list
+ *
+ * Releases the resident nodes and the head node of every run with the destructor, and
+ * closes the temporary files, which deletes them.
+ *
+ * @param pList - A pointer to the spill list that will be destroyed
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroySpillList(DSL_SpillList *pList);
+
+/**
+ * @brief DSL_SpillInsert inserts a node into a spill list
+ *
+ * Appends the node to the resident list in O(1). When the resident list already holds
+ * maxResident nodes it is first sorted, written to a new run with buffered sequential writes,
+ * and released. The nodes are only released once the whole run has been written, flushed and
+ * read back. If the spill fails they stay resident and the node is not inserted, so memory
+ * stays bounded by maxResident. Once maxOpenRuns runs are open, the newest runs of similar
+ * size are merged into one first. Nodes can still be inserted while the list is being popped.
+ *
+ * @param pNode - A pointer to the node that will be inserted
+ * @param pIntoList - A pointer to the spill list
+ * @return int - 1 on success, 0 if the resident nodes could not be spilled and the node was
+ * 				 not inserted
+ */
+DOUBLE_SEA_LIB_API int DSL_SpillInsert(void *pNode, DSL_SpillList *pIntoList);
+
+/**
+ * @brief DSL_SpillPeek returns the node the next DSL_SpillPop will return
+ *
+ * @param pList - A pointer to the spill list
+ * @return void* - A pointer to the first node in order, or NULL if the list is empty
+ */
+DOUBLE_SEA_LIB_API void *DSL_SpillPeek(DSL_SpillList *pList);
+
+/**
+ * @brief DSL_SpillPop removes the first node in order from a spill list and returns it
+ *
+ * Works like DSL_Pop across the resident list and every run, so popping until NULL streams
+ * the whole list in order. Nodes read back from a run were created by the DeserializeFunction
+ * and belong to the caller, as do popped resident nodes. A run's file is closed as soon as
+ * its last node has been popped.
+ *
+ * @param pFromList - A pointer to the spill list
+ * @return void* - A pointer to the removed node, or NULL once the list is empty
+ */
+DOUBLE_SEA_LIB_API void *DSL_SpillPop(DSL_SpillList *pFromList);
+
+/**
+ * @brief DSL_SpillLength returns the number of nodes in memory and on disk
+ *
+ * @param pList - A pointer to the spill list
+ * @return size_t - The number of nodes
+ */
+DOUBLE_SEA_LIB_API size_t DSL_SpillLength(DSL_SpillList *pList);
+
+#endif // DOUBLE_SEA_SPILL_H
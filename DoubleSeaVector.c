@@ -0,0 +1,619 @@
+#include "pch.h"
+#include <malloc.h>
+#include <string.h>
+#include "DoubleSeaVector.h"
+#include "DoubleSeaInline.h"
+
+// __________________________ Prototypes __________________________
+
+static size_t _LowerBound(DSL_SortedVector *pVector, void *pKey);
+static size_t _UpperBound(DSL_SortedVector *pVector, void *pKey);
+static int _MakeRoom(DSL_SortedVector *pVector);
+static void *_FindLinked(DSL_List *pList, void *pKey);
+static int _HoldsLinked(DSL_List *pList, void *pNode);
+static void _Adapt(DSL_AdaptiveList *pList);
+static void _MoveToVector(DSL_AdaptiveList *pList);
+static void _MoveToList(DSL_AdaptiveList *pList);
+
+// __________________________ Functions __________________________
+
+/**
+ * @brief DSL_InitSortedVector initializes a sorted vector
+ *
+ * @param pVector - A pointer to the vector that will be initialized
+ * @param pOrderFunction - A function pointer to the function that compares two elements
+ * @param capacity - The number of elements to reserve room for
+ * @return int - 1 on success, 0 if the storage could not be allocated
+ */
+int DSL_InitSortedVector(DSL_SortedVector *pVector, OrderFunction pOrderFunction, size_t capacity)
+{
+	if (!pVector || !pOrderFunction)
+	{
+		return 0;
+	}
+
+	if (capacity < 16)
+	{
+		capacity = 16;
+	}
+
+	pVector->ppItems = malloc(capacity * sizeof(void *));
+	if (!pVector->ppItems)
+	{
+		return 0;
+	}
+
+	pVector->first = 0;
+	pVector->length = 0;
+	pVector->capacity = capacity;
+	pVector->orderFunction = pOrderFunction;
+	return 1;
+}
+
+/**
+ * @brief DSL_DestroySortedVector releases the storage of a sorted vector
+ *
+ * The elements themselves are not touched.
+ *
+ * @param pVector - A pointer to the vector
+ */
+void DSL_DestroySortedVector(DSL_SortedVector *pVector)
+{
+	if (!pVector)
+	{
+		return;
+	}
+
+	free(pVector->ppItems);
+	pVector->ppItems = NULL;
+	pVector->first = 0;
+	pVector->length = 0;
+	pVector->capacity = 0;
+}
+
+/**
+ * @brief DSL_VectorInsert inserts an element in order
+ *
+ * Finds the position by binary search, after any equal elements like DSL_InsertNode, and
+ * moves the following pointers up by one.
+ *
+ * @param pVector - A pointer to the vector
+ * @param pElement - A pointer to the element
+ * @return int - 1 on success, 0 if the storage could not grow
+ */
+int DSL_VectorInsert(DSL_SortedVector *pVector, void *pElement)
+{
+	if (!pVector || !pElement || !pVector->ppItems)
+	{
+		return 0;
+	}
+
+	size_t position = _UpperBound(pVector, pElement);
+
+	// room freed by pops is used when the position is in the front half
+	if (pVector->first > 0 && position < pVector->length / 2)
+	{
+		void **ppFirst = &pVector->ppItems[pVector->first];
+		memmove(ppFirst - 1, ppFirst, position * sizeof(void *));
+		pVector->first--;
+	}
+	else
+	{
+		if (!_MakeRoom(pVector))
+		{
+			return 0;
+		}
+
+		void **ppAt = &pVector->ppItems[pVector->first + position];
+		memmove(ppAt + 1, ppAt, (pVector->length - position) * sizeof(void *));
+	}
+
+	pVector->ppItems[pVector->first + position] = pElement;
+	pVector->length++;
+	return 1;
+}
+
+/**
+ * @brief DSL_VectorRemove removes an element
+ *
+ * Finds the range of equal elements by binary search and removes the one that is pElement.
+ *
+ * @param pVector - A pointer to the vector
+ * @param pElement - A pointer to the element
+ * @return int - 1 if the element was removed, 0 if the vector doesn't hold it
+ */
+int DSL_VectorRemove(DSL_SortedVector *pVector, void *pElement)
+{
+	if (!pVector || !pElement || pVector->length == 0)
+	{
+		return 0;
+	}
+
+	void **ppItems = &pVector->ppItems[pVector->first];
+	for (size_t i = _LowerBound(pVector, pElement); i < pVector->length; i++)
+	{
+		if (ppItems[i] == pElement)
+		{
+			memmove(&ppItems[i], &ppItems[i + 1], (pVector->length - i - 1) * sizeof(void *));
+			if (--pVector->length == 0)
+			{
+				pVector->first = 0;
+			}
+			return 1;
+		}
+
+		if (pVector->orderFunction(ppItems[i], pElement) != 0)
+		{
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief DSL_VectorFind finds the first element equal to a key
+ *
+ * @param pVector - A pointer to the vector
+ * @param pKey - A pointer to an element the order function can compare against
+ * @return void* - A pointer to the first equal element, or NULL
+ */
+void *DSL_VectorFind(DSL_SortedVector *pVector, void *pKey)
+{
+	if (!pVector || !pKey || pVector->length == 0)
+	{
+		return NULL;
+	}
+
+	size_t position = _LowerBound(pVector, pKey);
+	if (position < pVector->length)
+	{
+		void *pElement = pVector->ppItems[pVector->first + position];
+		if (pVector->orderFunction(pElement, pKey) == 0)
+		{
+			return pElement;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief DSL_VectorPop removes the first element and returns it
+ *
+ * @param pVector - A pointer to the vector
+ * @return void* - A pointer to the removed element, or NULL if the vector is empty
+ */
+void *DSL_VectorPop(DSL_SortedVector *pVector)
+{
+	if (!pVector || pVector->length == 0)
+	{
+		return NULL;
+	}
+
+	void *pElement = pVector->ppItems[pVector->first++];
+	if (--pVector->length == 0)
+	{
+		pVector->first = 0;
+	}
+
+	return pElement;
+}
+
+/**
+ * @brief DSL_VectorAt returns the element at a position
+ *
+ * @param pVector - A pointer to the vector
+ * @param index - The position, 0 is the first element
+ * @return void* - A pointer to the element, or NULL if index is out of range
+ */
+void *DSL_VectorAt(DSL_SortedVector *pVector, size_t index)
+{
+	if (!pVector || index >= pVector->length)
+	{
+		return NULL;
+	}
+
+	return pVector->ppItems[pVector->first + index];
+}
+
+/**
+ * @brief DSL_InitAdaptiveList initializes an adaptive list
+ *
+ * The list starts out as a vector.
+ *
+ * @param pList - A pointer to the adaptive list that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param maxVectorLength - The largest length kept in the vector, 0 for DSL_ADAPTIVE_MAX_VECTOR
+ * @return int - 1 on success, 0 if the vector could not be allocated
+ */
+int DSL_InitAdaptiveList(DSL_AdaptiveList *pList, size_t offset, OrderFunction pOrderFunction, size_t maxVectorLength)
+{
+	if (!pList || !DSL_InitSortedVector(&pList->vector, pOrderFunction, 0))
+	{
+		return 0;
+	}
+
+	DSL_InitList(0, offset, &pList->list, pOrderFunction);
+	pList->useVector = 1;
+	pList->maxVectorLength = maxVectorLength ? maxVectorLength : DSL_ADAPTIVE_MAX_VECTOR;
+	pList->reads = 0;
+	pList->writes = 0;
+	pList->switches = 0;
+	return 1;
+}
+
+/**
+ * @brief DSL_DestroyAdaptiveList releases an adaptive list
+ *
+ * The nodes are not touched, pop them first if they need to be freed.
+ *
+ * @param pList - A pointer to the adaptive list
+ */
+void DSL_DestroyAdaptiveList(DSL_AdaptiveList *pList)
+{
+	if (!pList)
+	{
+		return;
+	}
+
+	DSL_DestroySortedVector(&pList->vector);
+	DSL_InitList(0, pList->list.offset, &pList->list, pList->list.orderFunction);
+}
+
+/**
+ * @brief DSL_AdaptiveInsert inserts a node in order
+ *
+ * @param pNode - A pointer to the node
+ * @param pIntoList - A pointer to the adaptive list
+ * @return int - 1 on success, 0 if the vector could not grow
+ */
+int DSL_AdaptiveInsert(void *pNode, DSL_AdaptiveList *pIntoList)
+{
+	if (!pIntoList || !pNode)
+	{
+		return 0;
+	}
+
+	int inserted = 1;
+	if (pIntoList->useVector)
+	{
+		inserted = DSL_VectorInsert(&pIntoList->vector, pNode);
+	}
+	else
+	{
+		DSL_InsertNode(pNode, &pIntoList->list);
+	}
+
+	if (inserted)
+	{
+		pIntoList->writes++;
+		_Adapt(pIntoList);
+	}
+	return inserted;
+}
+
+/**
+ * @brief DSL_AdaptiveRemove removes a node
+ *
+ * Checks that the node belongs to this list first, by binary search in vector mode or by
+ * walking back from the node to the head in list mode. Only removals that find the node
+ * count as writes.
+ *
+ * @param pNode - A pointer to the node
+ * @param pFromList - A pointer to the adaptive list that holds the node
+ * @return int - 1 if the node was removed, 0 if the list doesn't hold it
+ */
+int DSL_AdaptiveRemove(void *pNode, DSL_AdaptiveList *pFromList)
+{
+	if (!pFromList || !pNode)
+	{
+		return 0;
+	}
+
+	int removed = 0;
+	if (pFromList->useVector)
+	{
+		removed = DSL_VectorRemove(&pFromList->vector, pNode);
+	}
+	else if (_HoldsLinked(&pFromList->list, pNode))
+	{
+		DSL_RemoveNode(pNode, &pFromList->list);
+		removed = 1;
+	}
+
+	if (removed)
+	{
+		pFromList->writes++;
+		_Adapt(pFromList);
+	}
+	return removed;
+}
+
+/**
+ * @brief DSL_AdaptiveFind finds the first node equal to a key
+ *
+ * @param pList - A pointer to the adaptive list
+ * @param pKey - A pointer to a node the order function can compare against
+ * @return void* - A pointer to the first equal node, or NULL
+ */
+void *DSL_AdaptiveFind(DSL_AdaptiveList *pList, void *pKey)
+{
+	if (!pList || !pKey)
+	{
+		return NULL;
+	}
+
+	void *pNode = pList->useVector ? DSL_VectorFind(&pList->vector, pKey) : _FindLinked(&pList->list, pKey);
+
+	pList->reads++;
+	_Adapt(pList);
+	return pNode;
+}
+
+/**
+ * @brief DSL_AdaptivePop removes the first node and returns it
+ *
+ * @param pFromList - A pointer to the adaptive list
+ * @return void* - A pointer to the removed node, or NULL if the list is empty
+ */
+void *DSL_AdaptivePop(DSL_AdaptiveList *pFromList)
+{
+	if (!pFromList)
+	{
+		return NULL;
+	}
+
+	void *pNode = pFromList->useVector ? DSL_VectorPop(&pFromList->vector) : DSL_Pop(&pFromList->list);
+
+	if (pNode)
+	{
+		pFromList->writes++;
+		_Adapt(pFromList);
+	}
+	return pNode;
+}
+
+/**
+ * @brief DSL_AdaptiveLength returns the number of nodes in an adaptive list
+ *
+ * @param pList - A pointer to the adaptive list
+ * @return size_t - The number of nodes
+ */
+size_t DSL_AdaptiveLength(DSL_AdaptiveList *pList)
+{
+	if (!pList)
+	{
+		return 0;
+	}
+
+	return pList->useVector ? pList->vector.length : pList->list.length;
+}
+
+// __________________________ Static Functions __________________________
+
+/**
+ * @brief Finds the position of the first element that is not less than a key.
+ *
+ * @param pVector Pointer to the vector.
+ * @param pKey Pointer to the key.
+ * @return The position, length if every element is less.
+ */
+static size_t _LowerBound(DSL_SortedVector *pVector, void *pKey)
+{
+	void **ppItems = &pVector->ppItems[pVector->first];
+	size_t low = 0;
+	size_t high = pVector->length;
+
+	while (low < high)
+	{
+		size_t middle = low + ((high - low) / 2);
+		if (pVector->orderFunction(ppItems[middle], pKey) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/**
+ * @brief Finds the position of the first element that is greater than a key.
+ *
+ * @param pVector Pointer to the vector.
+ * @param pKey Pointer to the key.
+ * @return The position, length if no element is greater.
+ */
+static size_t _UpperBound(DSL_SortedVector *pVector, void *pKey)
+{
+	void **ppItems = &pVector->ppItems[pVector->first];
+	size_t low = 0;
+	size_t high = pVector->length;
+
+	while (low < high)
+	{
+		size_t middle = low + ((high - low) / 2);
+		if (pVector->orderFunction(ppItems[middle], pKey) <= 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/**
+ * @brief Makes sure there is room for one more pointer after the last element.
+ *
+ * Slides the elements back to the start when pops have freed room there, otherwise
+ * doubles the storage.
+ *
+ * @param pVector Pointer to the vector.
+ * @return 1 on success, 0 if the storage could not grow.
+ */
+static int _MakeRoom(DSL_SortedVector *pVector)
+{
+	if (pVector->first + pVector->length < pVector->capacity)
+	{
+		return 1;
+	}
+
+	if (pVector->first > 0)
+	{
+		memmove(pVector->ppItems, &pVector->ppItems[pVector->first], pVector->length * sizeof(void *));
+		pVector->first = 0;
+		return 1;
+	}
+
+	void **ppItems = realloc(pVector->ppItems, pVector->capacity * 2 * sizeof(void *));
+	if (!ppItems)
+	{
+		return 0;
+	}
+
+	pVector->ppItems = ppItems;
+	pVector->capacity *= 2;
+	return 1;
+}
+
+/**
+ * @brief Finds the first node equal to a key in an ordered list.
+ *
+ * @param pList Pointer to the ordered list.
+ * @param pKey Pointer to the key.
+ * @return The node, or NULL once the walk passes the key.
+ */
+static void *_FindLinked(DSL_List *pList, void *pKey)
+{
+	for (void *pNode = pList->pHead; pNode; pNode = *DSL_NextPointer(pNode, pList->offset))
+	{
+		int order = pList->orderFunction(pNode, pKey);
+		if (order == 0)
+			return pNode;
+		if (order > 0)
+			return NULL;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Checks whether a node is linked into a list by following its previous pointers.
+ *
+ * @param pList Pointer to the list.
+ * @param pNode Pointer to the node.
+ * @return 1 if the walk ends at the list's head, 0 if the node is unlinked or in another list.
+ */
+static int _HoldsLinked(DSL_List *pList, void *pNode)
+{
+	void *pFirst = pNode;
+	void *pPrev;
+	while ((pPrev = *DSL_PrevPointer(pFirst, pList->offset)) != NULL)
+	{
+		pFirst = pPrev;
+	}
+
+	return pFirst == pList->pHead;
+}
+
+/**
+ * @brief Moves the nodes to the representation that suits the recent operations.
+ *
+ * @param pList Pointer to the adaptive list.
+ */
+static void _Adapt(DSL_AdaptiveList *pList)
+{
+	if (pList->reads + pList->writes < DSL_ADAPTIVE_WINDOW)
+	{
+		return;
+	}
+
+	size_t length = DSL_AdaptiveLength(pList);
+	int useVector = length <= pList->maxVectorLength && pList->reads >= pList->writes;
+
+	pList->reads = 0;
+	pList->writes = 0;
+
+	if (useVector == pList->useVector)
+	{
+		return;
+	}
+
+	if (useVector)
+		_MoveToVector(pList);
+	else
+		_MoveToList(pList);
+}
+
+/**
+ * @brief Moves the linked nodes into the vector.
+ *
+ * @param pList Pointer to the adaptive list.
+ */
+static void _MoveToVector(DSL_AdaptiveList *pList)
+{
+	DSL_SortedVector *pVector = &pList->vector;
+	size_t length = pList->list.length;
+
+	// the list is already in order, so the pointers are copied straight in
+	while (pVector->capacity < length)
+	{
+		void **ppItems = realloc(pVector->ppItems, pVector->capacity * 2 * sizeof(void *));
+		if (!ppItems)
+		{
+			return;
+		}
+		pVector->ppItems = ppItems;
+		pVector->capacity *= 2;
+	}
+
+	// nodes held by the vector have no links, so the list can tell it doesn't hold them
+	size_t i = 0;
+	void *pNode = pList->list.pHead;
+	while (pNode)
+	{
+		void *pNext = *DSL_NextPointer(pNode, pList->list.offset);
+		*DSL_NextPointer(pNode, pList->list.offset) = NULL;
+		*DSL_PrevPointer(pNode, pList->list.offset) = NULL;
+		pVector->ppItems[i++] = pNode;
+		pNode = pNext;
+	}
+	pVector->first = 0;
+	pVector->length = length;
+
+	DSL_InitList(0, pList->list.offset, &pList->list, pList->list.orderFunction);
+	pList->useVector = 1;
+	pList->switches++;
+}
+
+/**
+ * @brief Links the vector's nodes into the list.
+ *
+ * @param pList Pointer to the adaptive list.
+ */
+static void _MoveToList(DSL_AdaptiveList *pList)
+{
+	DSL_SortedVector *pVector = &pList->vector;
+	size_t offset = pList->list.offset;
+	void *pPrev = NULL;
+
+	for (size_t i = 0; i < pVector->length; i++)
+	{
+		void *pNode = pVector->ppItems[pVector->first + i];
+		*DSL_PrevPointer(pNode, offset) = pPrev;
+		*DSL_NextPointer(pNode, offset) = NULL;
+		if (pPrev)
+			*DSL_NextPointer(pPrev, offset) = pNode;
+		else
+			pList->list.pHead = pNode;
+		pPrev = pNode;
+	}
+	pList->list.pTail = pPrev;
+	pList->list.length = pVector->length;
+
+	pVector->first = 0;
+	pVector->length = 0;
+	pList->useVector = 0;
+	pList->switches++;
+}
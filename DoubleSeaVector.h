@@ -0,0 +1,201 @@
+#pragma once
+
+#ifndef DOUBLE_SEA_VECTOR_H
+#define DOUBLE_SEA_VECTOR_H
+#include "DoubleSeaLib.h"
+
+// __________________________ Macros __________________________
+
+#define DSL_ADAPTIVE_MAX_VECTOR 4096 // Default largest length kept in the vector representation
+#define DSL_ADAPTIVE_WINDOW 256      // Number of operations between representation checks
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief DSL_SortedVector is a sorted array of element pointers.
+ *
+ * Lookups are binary searches over contiguous memory, and inserts and removals move the
+ * pointers behind the position with memmove. Pops only advance the first index.
+ *
+ * @param ppItems A pointer to the array of element pointers.
+ * @param first The index of the first element in ppItems.
+ * @param length The number of elements.
+ * @param capacity The number of pointers ppItems has room for.
+ * @param orderFunction A function pointer to the function that compares two elements.
+ */
+typedef struct DSL_SortedVector
+{
+	void **ppItems;
+	size_t first;
+	size_t length;
+	size_t capacity;
+	OrderFunction orderFunction;
+} DSL_SortedVector;
+
+/**
+ * @brief DSL_AdaptiveList is an ordered collection that picks its representation by use.
+ *
+ * The nodes are held either by a DSL_SortedVector or linked into a DSL_List. Every
+ * DSL_ADAPTIVE_WINDOW operations the list checks its length and the mix of reads and
+ * writes since the last check, and moves the nodes to the representation that suits them.
+ *
+ * @param list The linked representation.
+ * @param vector The vector representation.
+ * @param useVector 1 while the nodes are held by the vector.
+ * @param maxVectorLength The largest length that is kept in the vector.
+ * @param reads The number of finds since the last check.
+ * @param writes The number of inserts, removals and pops that changed the list since the last check.
+ * @param switches The number of times the representation changed.
+ */
+typedef struct DSL_AdaptiveList
+{
+	DSL_List list;
+	DSL_SortedVector vector;
+	int useVector;
+	size_t maxVectorLength;
+	size_t reads;
+	size_t writes;
+	size_t switches;
+} DSL_AdaptiveList;
+
+// __________________________ Function Prototypes __________________________
+
+/**
+ * @brief DSL_InitSortedVector initializes a sorted vector
+ *
+ * @param pVector - A pointer to the vector that will be initialized
+ * @param pOrderFunction - A function pointer to the function that compares two elements
+ * @param capacity - The number of elements to reserve room for
+ * @return int - 1 on success, 0 if the storage could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_InitSortedVector(DSL_SortedVector *pVector, OrderFunction pOrderFunction, size_t capacity);
+
+/**
+ * @brief DSL_DestroySortedVector releases the storage of a sorted vector
+ *
+ * The elements themselves are not touched.
+ *
+ * @param pVector - A pointer to the vector
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroySortedVector(DSL_SortedVector *pVector);
+
+/**
+ * @brief DSL_VectorInsert inserts an element in order
+ *
+ * Finds the position by binary search, after any equal elements like DSL_InsertNode, and
+ * moves the following pointers up by one.
+ *
+ * @param pVector - A pointer to the vector
+ * @param pElement - A pointer to the element
+ * @return int - 1 on success, 0 if the storage could not grow
+ */
+DOUBLE_SEA_LIB_API int DSL_VectorInsert(DSL_SortedVector *pVector, void *pElement);
+
+/**
+ * @brief DSL_VectorRemove removes an element
+ *
+ * Finds the range of equal elements by binary search and removes the one that is pElement.
+ *
+ * @param pVector - A pointer to the vector
+ * @param pElement - A pointer to the element
+ * @return int - 1 if the element was removed, 0 if the vector doesn't hold it
+ */
+DOUBLE_SEA_LIB_API int DSL_VectorRemove(DSL_SortedVector *pVector, void *pElement);
+
+/**
+ * @brief DSL_VectorFind finds the first element equal to a key
+ *
+ * @param pVector - A pointer to the vector
+ * @param pKey - A pointer to an element the order function can compare against
+ * @return void* - A pointer to the first equal element, or NULL
+ */
+DOUBLE_SEA_LIB_API void *DSL_VectorFind(DSL_SortedVector *pVector, void *pKey);
+
+/**
+ * @brief DSL_VectorPop removes the first element and returns it
+ *
+ * @param pVector - A pointer to the vector
+ * @return void* - A pointer to the removed element, or NULL if the vector is empty
+ */
+DOUBLE_SEA_LIB_API void *DSL_VectorPop(DSL_SortedVector *pVector);
+
+/**
+ * @brief DSL_VectorAt returns the element at a position
+ *
+ * @param pVector - A pointer to the vector
+ * @param index - The position, 0 is the first element
+ * @return void* - A pointer to the element, or NULL if index is out of range
+ */
+DOUBLE_SEA_LIB_API void *DSL_VectorAt(DSL_SortedVector *pVector, size_t index);
+
+/**
+ * @brief DSL_InitAdaptiveList initializes an adaptive list
+ *
+ * The list starts out as a vector.
+ *
+ * @param pList - A pointer to the adaptive list that will be initialized
+ * @param offset - The offset to the pNext pointers in the nodes
+ * @param pOrderFunction - A function pointer to the function that compares two nodes
+ * @param maxVectorLength - The largest length kept in the vector, 0 for DSL_ADAPTIVE_MAX_VECTOR
+ * @return int - 1 on success, 0 if the vector could not be allocated
+ */
+DOUBLE_SEA_LIB_API int DSL_InitAdaptiveList(DSL_AdaptiveList *pList, size_t offset, OrderFunction pOrderFunction,
+											size_t maxVectorLength);
+
+/**
+ * @brief DSL_DestroyAdaptiveList releases an adaptive list
+ *
+ * The nodes are not touched, pop them first if they need to be freed.
+ *
+ * @param pList - A pointer to the adaptive list
+ */
+DOUBLE_SEA_LIB_API void DSL_DestroyAdaptiveList(DSL_AdaptiveList *pList);
+
+/**
+ * @brief DSL_AdaptiveInsert inserts a node in order
+ *
+ * @param pNode - A pointer to the node
+ * @param pIntoList - A pointer to the adaptive list
+ * @return int - 1 on success, 0 if the vector could not grow
+ */
+DOUBLE_SEA_LIB_API int DSL_AdaptiveInsert(void *pNode, DSL_AdaptiveList *pIntoList);
+
+/**
+ * @brief DSL_AdaptiveRemove removes a node
+ *
+ * Checks that the node belongs to this list first, by binary search in vector mode or by
+ * walking back from the node to the head in list mode. Only removals that find the node
+ * count as writes.
+ *
+ * @param pNode - A pointer to the node
+ * @param pFromList - A pointer to the adaptive list that holds the node
+ * @return int - 1 if the node was removed, 0 if the list doesn't hold it
+ */
+DOUBLE_SEA_LIB_API int DSL_AdaptiveRemove(void *pNode, DSL_AdaptiveList *pFromList);
+
+/**
+ * @brief DSL_AdaptiveFind finds the first node equal to a key
+ *
+ * @param pList - A pointer to the adaptive list
+ * @param pKey - A pointer to a node the order function can compare against
+ * @return void* - A pointer to the first equal node, or NULL
+ */
+DOUBLE_SEA_LIB_API void *DSL_AdaptiveFind(DSL_AdaptiveList *pList, void *pKey);
+
+/**
+ * @brief DSL_AdaptivePop removes the first node and returns it
+ *
+ * @param pFromList - A pointer to the adaptive list
+ * @return void* - A pointer to the removed node, or NULL if the list is empty
+ */
+DOUBLE_SEA_LIB_API void *DSL_AdaptivePop(DSL_AdaptiveList *pFromList);
+
+/**
+ * @brief DSL_AdaptiveLength returns the number of nodes in an adaptive list
+ *
+ * @param pList - A pointer to the adaptive list
+ * @return size_t - The number of nodes
+ */
+DOUBLE_SEA_LIB_API size_t DSL_AdaptiveLength(DSL_AdaptiveList *pList);
+
+#endif // DOUBLE_SEA_VECTOR_H
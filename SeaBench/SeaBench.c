@@ -0,0 +1,1182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "../DoubleSeaLib.h"
+#include "../DoubleSeaDeque.h"
+#include "../DoubleSeaShards.h"
+#include "../DoubleSeaPlatform.h"
+#include "../DoubleSeaInline.h"
+#include "../DoubleSeaSpill.h"
+#include "../DoubleSeaVector.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define MAX_WORKERS 64
+#define TASK_TREE_DEPTH 20
+#define TASK_COUNT ((1 << (TASK_TREE_DEPTH + 1)) - 1)
+#define LEAF_WORK 64
+#define STEAL_ATTEMPTS 8
+#define INSERTS_PER_RUN 16384
+#define SCAN_ENTRIES (1 << 20)
+#define SCAN_LOOKUPS 16
+
+// __________________________ Typedefs and Structures __________________________
+
+/**
+ * @brief Task is an intrusive node that the schedulers move between workers.
+ *
+ * Task i spawns tasks 2i + 1 and 2i + 2, so the whole run is a complete binary tree that
+ * starts on worker 0 and has to be spread out by stealing.
+ */
+typedef struct Task
+{
+	void* pData;
+	void* pNext;
+	void* pPrev;
+	size_t index;
+} Task;
+
+typedef struct Scheduler Scheduler;
+
+/**
+ * @brief Worker is the per-thread state of a scheduler.
+ */
+typedef struct Worker
+{
+	Scheduler* pScheduler;
+	size_t id;
+	unsigned int seed;
+	int64_t executed;
+	int64_t steals;
+	unsigned long long sink;  // keeps the leaf work from being optimized away
+	DSL_Deque deque;     // used by the work-stealing scheduler
+	DSL_List queue;      // used by the locked baseline
+	DSL_Mutex lock;      // guards queue
+	char padding[DSL_CACHE_LINE_SIZE];
+} Worker;
+
+/**
+ * @brief Scheduler is a small reference scheduler over per-worker queues.
+ */
+struct Scheduler
+{
+	size_t workerCount;
+	int useDeque;
+	volatile int64_t remaining;
+	Worker workers[MAX_WORKERS];
+};
+
+Task tasks[TASK_COUNT];
+volatile unsigned char executedTasks[TASK_COUNT];
+
+// __________________________ Helpers __________________________
+
+/**
+ * @brief Returns a monotonic timestamp in seconds.
+ */
+double now()
+{
+#ifdef _WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+/**
+ * @brief Returns the number of logical processors.
+ */
+size_t processorCount()
+{
+#ifdef _WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	return info.dwNumberOfProcessors;
+#else
+	long count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? (size_t)count : 1;
+#endif
+}
+
+/**
+ * @brief Small xorshift generator used to pick steal victims.
+ */
+unsigned int nextRandom(unsigned int* pSeed)
+{
+	unsigned int x = *pSeed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *pSeed = x;
+}
+
+/**
+ * @brief ThreadStart carries a body and its argument to a new thread.
+ */
+typedef struct ThreadStart
+{
+	void (*body)(void*);
+	void* pArg;
+} ThreadStart;
+
+#ifdef _WIN32
+DWORD WINAPI threadMain(LPVOID pStart)
+{
+	((ThreadStart*)pStart)->body(((ThreadStart*)pStart)->pArg);
+	return 0;
+}
+#else
+void* threadMain(void* pStart)
+{
+	((ThreadStart*)pStart)->body(((ThreadStart*)pStart)->pArg);
+	return NULL;
+}
+#endif
+
+/**
+ * @brief Runs body(args[i]) on count threads, the calling thread takes args[0].
+ */
+void runOnThreads(size_t count, void (*body)(void*), void** args)
+{
+	ThreadStart starts[MAX_WORKERS];
+#ifdef _WIN32
+	HANDLE threads[MAX_WORKERS];
+	for (size_t i = 1; i < count; i++)
+	{
+		starts[i].body = body;
+		starts[i].pArg = args[i];
+		threads[i] = CreateThread(NULL, 0, threadMain, &starts[i], 0, NULL);
+	}
+	body(args[0]);
+	for (size_t i = 1; i < count; i++)
+	{
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+	}
+#else
+	pthread_t threads[MAX_WORKERS];
+	for (size_t i = 1; i < count; i++)
+	{
+		starts[i].body = body;
+		starts[i].pArg = args[i];
+		pthread_create(&threads[i], NULL, threadMain, &starts[i]);
+	}
+	body(args[0]);
+	for (size_t i = 1; i < count; i++)
+		pthread_join(threads[i], NULL);
+#endif
+}
+
+// __________________________ Reference Scheduler __________________________
+
+/**
+ * @brief Adds a task to the calling worker's own queue.
+ */
+void submit(Worker* pWorker, Task* pTask)
+{
+	if (pWorker->pScheduler->useDeque)
+	{
+		DSL_DequePush(&pWorker->deque, pTask);
+	}
+	else
+	{
+		DSL_LockMutex(&pWorker->lock);
+		DSL_Push(pTask, &pWorker->queue);
+		DSL_UnlockMutex(&pWorker->lock);
+	}
+}
+
+/**
+ * @brief Takes the newest task from the calling worker's own queue.
+ */
+Task* takeOwn(Worker* pWorker)
+{
+	if (pWorker->pScheduler->useDeque)
+	{
+		return DSL_DequePop(&pWorker->deque);
+	}
+
+	DSL_LockMutex(&pWorker->lock);
+	Task* pTask = DSL_Pop(&pWorker->queue);
+	DSL_UnlockMutex(&pWorker->lock);
+	return pTask;
+}
+
+/**
+ * @brief Takes the oldest task from another worker's queue.
+ */
+Task* stealFrom(Worker* pVictim)
+{
+	if (pVictim->pScheduler->useDeque)
+	{
+		return DSL_DequeSteal(&pVictim->deque);
+	}
+
+	DSL_LockMutex(&pVictim->lock);
+	Task* pTask = pVictim->queue.pTail;
+	DSL_RemoveNode(pTask, &pVictim->queue);
+	DSL_UnlockMutex(&pVictim->lock);
+	return pTask;
+}
+
+/**
+ * @brief Runs a task: leaves do a little arithmetic, inner tasks spawn two children.
+ */
+void runTask(Worker* pWorker, Task* pTask)
+{
+	executedTasks[pTask->index]++;
+
+	size_t left = (2 * pTask->index) + 1;
+	if (left < TASK_COUNT)
+	{
+		submit(pWorker, &tasks[left + 1]);
+		submit(pWorker, &tasks[left]);
+		return;
+	}
+
+	unsigned long long work = pTask->index;
+	for (int i = 0; i < LEAF_WORK; i++)
+	{
+		work = (work * 6364136223846793005ULL) + 1442695040888963407ULL;
+	}
+	pWorker->sink += work;
+}
+
+/**
+ * @brief Worker loop: drain the own queue, then steal from random victims until every task ran.
+ */
+void workerLoop(void* pArg)
+{
+	Worker* pWorker = pArg;
+	Scheduler* pScheduler = pWorker->pScheduler;
+
+	while (DSL_LoadAcquire64(&pScheduler->remaining) > 0)
+	{
+		Task* pTask = takeOwn(pWorker);
+
+		for (int attempt = 0; !pTask && attempt < STEAL_ATTEMPTS && pScheduler->workerCount > 1; attempt++)
+		{
+			size_t victim = nextRandom(&pWorker->seed) % pScheduler->workerCount;
+			if (victim != pWorker->id)
+			{
+				pTask = stealFrom(&pScheduler->workers[victim]);
+				pWorker->steals += pTask != NULL;
+			}
+		}
+
+		if (pTask)
+		{
+			runTask(pWorker, pTask);
+			pWorker->executed++;
+			DSL_FetchAdd64(&pScheduler->remaining, -1);
+		}
+	}
+}
+
+/**
+ * @brief Runs the task tree on workerCount threads and reports throughput.
+ */
+void runScheduler(Scheduler* pScheduler, size_t workerCount, int useDeque)
+{
+	pScheduler->workerCount = workerCount;
+	pScheduler->useDeque = useDeque;
+	pScheduler->remaining = TASK_COUNT;
+
+	for (size_t i = 0; i < TASK_COUNT; i++)
+	{
+		tasks[i].index = i;
+		executedTasks[i] = 0;
+	}
+
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		Worker* pWorker = &pScheduler->workers[i];
+		pWorker->pScheduler = pScheduler;
+		pWorker->id = i;
+		pWorker->seed = (unsigned int)(i * 2654435761u) | 1;
+		pWorker->executed = 0;
+		pWorker->steals = 0;
+		DSL_InitDeque(&pWorker->deque, OFFSETOF_DSL_NODE, 1024);
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &pWorker->queue, NULL);
+		DSL_InitMutex(&pWorker->lock);
+	}
+
+	// the whole tree starts on worker 0
+	submit(&pScheduler->workers[0], &tasks[0]);
+
+	void* args[MAX_WORKERS];
+	for (size_t i = 0; i < workerCount; i++)
+		args[i] = &pScheduler->workers[i];
+
+	double start = now();
+	runOnThreads(workerCount, workerLoop, args);
+	double elapsed = now() - start;
+
+	int64_t steals = 0;
+	for (size_t i = 0; i < workerCount; i++)
+	{
+		steals += pScheduler->workers[i].steals;
+		DSL_DestroyDeque(&pScheduler->workers[i].deque);
+		DSL_DestroyMutex(&pScheduler->workers[i].lock);
+	}
+
+	for (size_t i = 0; i < TASK_COUNT; i++)
+	{
+		if (executedTasks[i] != 1)
+		{
+			printf("  task %zu ran %d times\n", i, executedTasks[i]);
+			exit(1);
+		}
+	}
+
+	printf("  %-14s %3zu threads  %8.2f Mtasks/s  %8.2f Msteals/s  %10lld steals\n",
+		   useDeque ? "DSL_Deque" : "locked DSL_List", workerCount,
+		   TASK_COUNT / elapsed / 1e6, steals / elapsed / 1e6, (long long)steals);
+}
+
+// __________________________ Benchmarks __________________________
+
+/**
+ * @brief Compares the Chase-Lev deque with a mutex per DSL_List queue under heavy stealing.
+ */
+void benchWorkStealing()
+{
+	static Scheduler scheduler;
+	size_t cores = processorCount();
+	if (cores > MAX_WORKERS)
+		cores = MAX_WORKERS;
+
+	printf("Work stealing: %d tasks spawned as a binary tree from one worker\n", TASK_COUNT);
+	for (size_t workers = 1; workers <= cores; workers *= 2)
+	{
+		runScheduler(&scheduler, workers, 0);
+		runScheduler(&scheduler, workers, 1);
+	}
+}
+
+/**
+ * @brief InsertJob is one thread's share of the ordered insert benchmark.
+ */
+typedef struct InsertJob
+{
+	DSL_Node* pNodes;
+	size_t count;
+	DSL_List* pList;            // single list baseline
+	DSL_Mutex* pLock;           // guards pList
+	DSL_ShardedList* pSharded;  // sharded list under test
+} InsertJob;
+
+DSL_Node insertNodes[INSERTS_PER_RUN];
+int insertKeys[INSERTS_PER_RUN];
+
+/**
+ * @brief Orders DSL_Node nodes by the int they point to.
+ */
+int orderByKey(void* pNode1, void* pNode2)
+{
+	int key1 = *(int*)((DSL_Node*)pNode1)->pData;
+	int key2 = *(int*)((DSL_Node*)pNode2)->pData;
+	return (key1 > key2) - (key1 < key2);
+}
+
+void insertLocked(void* pArg)
+{
+	InsertJob* pJob = pArg;
+	for (size_t i = 0; i < pJob->count; i++)
+	{
+		DSL_LockMutex(pJob->pLock);
+		DSL_InsertNode(&pJob->pNodes[i], pJob->pList);
+		DSL_UnlockMutex(pJob->pLock);
+	}
+}
+
+void insertSharded(void* pArg)
+{
+	InsertJob* pJob = pArg;
+	for (size_t i = 0; i < pJob->count; i++)
+	{
+		DSL_ShardedInsert(&pJob->pNodes[i], pJob->pSharded);
+	}
+}
+
+/**
+ * @brief Compares ordered inserts into one locked DSL_List with a DSL_ShardedList sharded by thread.
+ */
+void benchShardedInsert()
+{
+	size_t cores = processorCount();
+	if (cores > MAX_WORKERS)
+		cores = MAX_WORKERS;
+
+	unsigned int seed = 12345;
+	for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+	{
+		insertKeys[i] = (int)(nextRandom(&seed) & 0x7FFFFFFF);
+	}
+
+	printf("Ordered inserts: %d random keys split across threads\n", INSERTS_PER_RUN);
+	for (size_t threads = 1; threads <= cores; threads *= 2)
+	{
+		DSL_List list;
+		DSL_Mutex lock;
+		DSL_ShardedList sharded;
+		InsertJob jobs[MAX_WORKERS];
+		void* args[MAX_WORKERS];
+
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderByKey);
+		DSL_InitMutex(&lock);
+		DSL_InitShardedList(&sharded, threads, OFFSETOF_DSL_NODE, orderByKey, NULL);
+
+		for (size_t i = 0; i < threads; i++)
+		{
+			jobs[i].pNodes = &insertNodes[i * (INSERTS_PER_RUN / threads)];
+			jobs[i].count = INSERTS_PER_RUN / threads;
+			jobs[i].pList = &list;
+			jobs[i].pLock = &lock;
+			jobs[i].pSharded = &sharded;
+			args[i] = &jobs[i];
+		}
+
+		for (int shardedRun = 0; shardedRun < 2; shardedRun++)
+		{
+			for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+			{
+				DSL_InitNode(0, &insertNodes[i], &insertKeys[i]);
+			}
+
+			double start = now();
+			runOnThreads(threads, shardedRun ? insertSharded : insertLocked, args);
+			double insertTime = now() - start;
+
+			double drainTime = 0;
+			if (shardedRun)
+			{
+				DSL_List drained;
+				DSL_InitList(0, OFFSETOF_DSL_NODE, &drained, orderByKey);
+				start = now();
+				DSL_ShardedDrain(&sharded, &drained);
+				drainTime = now() - start;
+			}
+
+			printf("  %-15s %3zu threads  %8.3f Minserts/s  drain %7.3f ms\n",
+				   shardedRun ? "DSL_ShardedList" : "locked DSL_List", threads,
+				   (INSERTS_PER_RUN / threads) * threads / insertTime / 1e6, drainTime * 1e3);
+		}
+
+		DSL_DestroyShardedList(&sharded, NULL, NULL);
+		DSL_DestroyMutex(&lock);
+	}
+}
+
+/**
+ * @brief ScanEntry is an element of the static storage table used by the scan benchmark.
+ */
+typedef struct ScanEntry
+{
+	int key;
+	size_t index;
+	void* pData;
+	void* pNext;
+	void* pPrev;
+} ScanEntry;
+
+/**
+ * @brief Compares DSL_FindNode with the direct static storage scans on a table linked in random order.
+ */
+void benchStaticStorageScan()
+{
+	ScanEntry* entries = malloc(SCAN_ENTRIES * sizeof(ScanEntry));
+	size_t* permutation = malloc(SCAN_ENTRIES * sizeof(size_t));
+	if (!entries || !permutation)
+		return;
+
+	DSL_List list;
+	DSL_InitList(0, offsetof(ScanEntry, pNext), &list, NULL);
+	DSL_InitStaticStorageListArgs args = { entries, offsetof(ScanEntry, pNext), SCAN_ENTRIES, &list,
+										   sizeof(ScanEntry), offsetof(ScanEntry, index), NULL };
+	DSL_InitStaticStorageListWData(&args);
+
+	// relink the table in a random order so every hop of DSL_FindNode is a cache miss
+	unsigned int seed = 777;
+	for (size_t i = 0; i < SCAN_ENTRIES; i++)
+	{
+		permutation[i] = i;
+		entries[i].key = (int)i;
+		entries[i].pData = &entries[i];
+	}
+	for (size_t i = SCAN_ENTRIES - 1; i > 0; i--)
+	{
+		size_t j = nextRandom(&seed) % (i + 1);
+		size_t swap = permutation[i];
+		permutation[i] = permutation[j];
+		permutation[j] = swap;
+	}
+	DSL_InitList(0, offsetof(ScanEntry, pNext), &list, NULL);
+	for (size_t i = 0; i < SCAN_ENTRIES; i++)
+	{
+		DSL_Push(&entries[permutation[i]], &list);
+	}
+
+	size_t targets[SCAN_LOOKUPS];
+	for (int i = 0; i < SCAN_LOOKUPS; i++)
+	{
+		targets[i] = nextRandom(&seed) % SCAN_ENTRIES;
+	}
+
+	printf("Static storage lookups: %d entries of %zu bytes, %d lookups\n", SCAN_ENTRIES, sizeof(ScanEntry), SCAN_LOOKUPS);
+	for (int method = 0; method < 4; method++)
+	{
+		size_t found = 0;
+		double start = now();
+		if (method == 3)
+		{
+			// the whole batch shares one walk of the list
+			void* keys[SCAN_LOOKUPS];
+			void** results[SCAN_LOOKUPS];
+			for (int i = 0; i < SCAN_LOOKUPS; i++)
+				keys[i] = entries[targets[i]].pData;
+			DSL_FindNodeBatch(&list, keys, SCAN_LOOKUPS, results);
+			for (int i = 0; i < SCAN_LOOKUPS; i++)
+				found += results[i] && *results[i] == &entries[targets[i]];
+		}
+		for (int i = 0; method < 3 && i < SCAN_LOOKUPS; i++)
+		{
+			ScanEntry* pTarget = &entries[targets[i]];
+			void* pFound;
+			if (method == 0)
+				pFound = *DSL_FindNode(&list, pTarget->pData);
+			else if (method == 1)
+				pFound = DSL_FindStaticStorageNode(&args, pTarget->pData);
+			else
+				pFound = DSL_FindStaticStorageKey(&args, offsetof(ScanEntry, key), sizeof(int), pTarget->key);
+			found += pFound == pTarget;
+		}
+		double elapsed = now() - start;
+
+		printf("  %-26s %8.3f ms/lookup  %zu/%d found\n",
+			   method == 0 ? "DSL_FindNode" : method == 1 ? "DSL_FindStaticStorageNode" : method == 2 ? "DSL_FindStaticStorageKey" : "DSL_FindNodeBatch",
+			   elapsed * 1e3 / SCAN_LOOKUPS, found, SCAN_LOOKUPS);
+	}
+
+	free(permutation);
+	free(entries);
+}
+
+/**
+ * @brief Compares ingesting random keys with ordered inserts against deferred ordering plus one settle.
+ */
+void benchDeferredOrder()
+{
+	unsigned int seed = 4242;
+	for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+	{
+		insertKeys[i] = (int)(nextRandom(&seed) & 0x7FFFFFFF);
+	}
+
+	printf("Ingest then flush: %d random keys\n", INSERTS_PER_RUN);
+	for (int deferred = 0; deferred < 2; deferred++)
+	{
+		DSL_List list;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderByKey);
+		DSL_SetDeferredOrder(&list, deferred);
+
+		double start = now();
+		for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+		{
+			DSL_InitNode(0, &insertNodes[i], &insertKeys[i]);
+			DSL_InsertNode(&insertNodes[i], &list);
+		}
+		double ingest = now() - start;
+
+		start = now();
+		int previous = -1;
+		while (list.length > 0)
+		{
+			DSL_Node* pNode = DSL_Pop(&list);
+			int key = *(int*)pNode->pData;
+			if (key < previous)
+			{
+				printf("  out of order flush\n");
+				exit(1);
+			}
+			previous = key;
+		}
+		double flush = now() - start;
+
+		printf("  %-16s ingest %9.3f ms  flush %7.3f ms\n", deferred ? "deferred order" : "ordered inserts",
+			   ingest * 1e3, flush * 1e3);
+	}
+}
+
+/**
+ * @brief Compares per-request scratch lists of malloc'd nodes with arena-backed lists.
+ */
+void benchArenaList()
+{
+	const int requests = 64;
+	printf("Scratch lists: %d requests of %d nodes\n", requests, INSERTS_PER_RUN);
+
+	for (int arena = 0; arena < 2; arena++)
+	{
+		DSL_List list;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+		if (arena)
+			DSL_EnableArena(&list, 64 * 1024);
+
+		double build = 0, teardown = 0;
+		for (int request = 0; request < requests; request++)
+		{
+			double start = now();
+			for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+			{
+				DSL_Node* pNode = arena ? DSL_ArenaAllocNode(&list, &insertKeys[i]) : malloc(sizeof(DSL_Node));
+				if (!arena)
+					DSL_InitNode(1, pNode, &insertKeys[i]);
+				DSL_Push(pNode, &list);
+			}
+			build += now() - start;
+
+			start = now();
+			if (arena)
+			{
+				DSL_ResetList(&list);
+			}
+			else
+			{
+				DSL_DestroyList(&list, 1);
+				DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+			}
+			teardown += now() - start;
+		}
+
+		DSL_DestroyList(&list, 1);
+		printf("  %-16s build %7.3f ms  teardown %7.3f ms per request\n", arena ? "arena list" : "malloc'd nodes",
+			   build * 1e3 / requests, teardown * 1e3 / requests);
+	}
+}
+
+void benchFilteredLookup()
+{
+	const int lookups = 4096;
+	printf("Miss-heavy lookups: %d lookups, 1 in 16 hits, list of %d nodes\n", lookups, INSERTS_PER_RUN);
+
+	DSL_Node* nodes = malloc(sizeof(DSL_Node) * INSERTS_PER_RUN);
+	int* absent = malloc(sizeof(int) * lookups);
+	for (int filter = 0; filter < 2; filter++)
+	{
+		DSL_List list;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+		if (filter)
+			DSL_EnableFilter(&list, INSERTS_PER_RUN, 0.01);
+		for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+		{
+			DSL_InitNode(0, &nodes[i], &insertKeys[i]);
+			DSL_Push(&nodes[i], &list);
+		}
+
+		int found = 0;
+		double start = now();
+		for (int i = 0; i < lookups; i++)
+		{
+			void* pData = (i % 16 == 0) ? (void*)&insertKeys[(i * 7) % INSERTS_PER_RUN] : (void*)&absent[i];
+			found += DSL_Contains(&list, pData);
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s %9.3f us per lookup  (%d found)\n", filter ? "counting filter" : "plain scan", elapsed * 1e6 / lookups, found);
+		DSL_FilterStats stats;
+		if (DSL_GetFilterStats(&list, &stats))
+		{
+			printf("  %-16s %zu bytes, %zu hashes, estimated fp rate %.4f, %zu definite misses, %zu false positives\n", "",
+				   stats.memoryBytes, stats.hashCount, stats.estimatedFalsePositiveRate, stats.definiteMisses, stats.falsePositives);
+		}
+		DSL_DisableFilter(&list);
+	}
+	free(absent);
+	free(nodes);
+}
+
+/**
+ * @brief Compares push, walk and pop through the library functions against the inline header.
+ */
+void benchInlineFastPath()
+{
+	const int rounds = 256;
+	printf("Push, walk and pop: %d rounds of %d nodes\n", rounds, INSERTS_PER_RUN);
+
+	DSL_Node* nodes = malloc(sizeof(DSL_Node) * INSERTS_PER_RUN);
+	for (int useInline = 0; useInline < 2; useInline++)
+	{
+		DSL_List list;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+		size_t sum = 0;
+
+		double start = now();
+		for (int round = 0; round < rounds; round++)
+		{
+			for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+			{
+				nodes[i].pData = &insertKeys[i];
+				if (useInline)
+					DSL_PushInline(&nodes[i], &list);
+				else
+					DSL_Push(&nodes[i], &list);
+			}
+
+			for (void* pNode = list.pHead; pNode;)
+			{
+				if (useInline)
+				{
+					sum += *(int*)*DSL_DataPointer(pNode, list.offset);
+					pNode = *DSL_NextPointer(pNode, list.offset);
+				}
+				else
+				{
+					sum += *(int*)*_GetDataPointer(pNode, list.offset);
+					pNode = *_GetNextPointer(pNode, list.offset);
+				}
+			}
+
+			while (useInline ? DSL_PopInline(&list) : DSL_Pop(&list))
+				;
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s %7.2f ns per node  (checksum %zu)\n", useInline ? "inline header" : "library calls",
+			   elapsed * 1e9 / ((double)rounds * INSERTS_PER_RUN), sum);
+	}
+	free(nodes);
+}
+
+#define SPILL_ITEMS (1 << 20)
+#define SPILL_PAYLOAD 48
+
+typedef struct SpillRecord
+{
+	DSL_Node node;
+	int key;
+	char payload[SPILL_PAYLOAD];
+} SpillRecord;
+
+int orderByRecord(void* pNode1, void* pNode2)
+{
+	int a = ((SpillRecord*)pNode1)->key;
+	int b = ((SpillRecord*)pNode2)->key;
+	return (a > b) - (a < b);
+}
+
+size_t writeRecord(void* pNode, void* pBuffer, size_t bufferSize, void* pCtx)
+{
+	size_t size = sizeof(int) + SPILL_PAYLOAD;
+	if (bufferSize >= size)
+		memcpy(pBuffer, &((SpillRecord*)pNode)->key, size);
+	return size;
+}
+
+void* readRecord(const void* pBuffer, size_t size, void* pCtx)
+{
+	SpillRecord* pRecord = malloc(sizeof(SpillRecord));
+	memcpy(&pRecord->key, pBuffer, size);
+	DSL_InitNode(1, &pRecord->node, &pRecord->key);
+	return pRecord;
+}
+
+void freeRecord(void* pNode, void* pCtx)
+{
+	free(pNode);
+}
+
+/**
+ * @brief Streams random records through a spill list that holds a sixteenth of them in memory.
+ */
+void benchSpillList()
+{
+	const size_t maxResident = SPILL_ITEMS / 16;
+	double megabytes = (double)SPILL_ITEMS * (sizeof(size_t) + sizeof(int) + SPILL_PAYLOAD) / (1024.0 * 1024.0);
+	printf("Spill list: %d records of %d bytes, %zu resident\n", SPILL_ITEMS, (int)(sizeof(int) + SPILL_PAYLOAD), maxResident);
+
+	DSL_SpillList list;
+	DSL_InitSpillList(&list, OFFSETOF_DSL_NODE, orderByRecord, maxResident, writeRecord, readRecord, freeRecord, NULL);
+
+	unsigned int seed = 4242;
+	double start = now();
+	for (size_t i = 0; i < SPILL_ITEMS; i++)
+	{
+		SpillRecord* pRecord = malloc(sizeof(SpillRecord));
+		pRecord->key = (int)(nextRandom(&seed) & 0x7FFFFFFF);
+		memset(pRecord->payload, (int)i, SPILL_PAYLOAD);
+		DSL_InitNode(1, &pRecord->node, &pRecord->key);
+		if (!DSL_SpillInsert(&pRecord->node, &list))
+			free(pRecord);
+	}
+	double ingest = now() - start;
+	size_t runs = list.runCount;
+
+	start = now();
+	size_t inOrder = 0;
+	int previous = -1;
+	SpillRecord* pRecord;
+	while ((pRecord = DSL_SpillPop(&list)) != NULL)
+	{
+		inOrder += pRecord->key >= previous;
+		previous = pRecord->key;
+		free(pRecord);
+	}
+	double drain = now() - start;
+
+	printf("  %zu runs, ingest %.1f MB/s, ordered drain %.1f MB/s, %zu/%d in order%s\n", runs,
+		   megabytes / ingest, megabytes / drain, inOrder, SPILL_ITEMS, list.ioError ? ", I/O error" : "");
+	DSL_DestroySpillList(&list);
+}
+
+/**
+ * @brief Compares combining per-thread ordered lists by pop and insert against DSL_MergeK.
+ */
+void benchMergeK()
+{
+	const size_t k = 16;
+	printf("Combine ordered lists: %zu lists, %d nodes in total\n", k, INSERTS_PER_RUN);
+
+	DSL_Node* nodes = malloc(sizeof(DSL_Node) * INSERTS_PER_RUN);
+	DSL_List lists[16];
+	DSL_List* pLists[16];
+	for (int method = 0; method < 2; method++)
+	{
+		for (size_t i = 0; i < k; i++)
+		{
+			DSL_InitList(0, OFFSETOF_DSL_NODE, &lists[i], orderByKey);
+			DSL_SetDeferredOrder(&lists[i], 1);
+			pLists[i] = &lists[i];
+		}
+		for (size_t i = 0; i < INSERTS_PER_RUN; i++)
+		{
+			DSL_InitNode(0, &nodes[i], &insertKeys[i]);
+			DSL_InsertNode(&nodes[i], &lists[i % k]);
+		}
+		for (size_t i = 0; i < k; i++)
+			DSL_SettleOrder(&lists[i]);
+
+		DSL_List combined;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &combined, orderByKey);
+		double start = now();
+		if (method == 0)
+		{
+			for (size_t i = 0; i < k; i++)
+			{
+				void* pNode;
+				while ((pNode = DSL_Pop(&lists[i])) != NULL)
+					DSL_InsertNode(pNode, &combined);
+			}
+		}
+		else
+		{
+			DSL_MergeK(pLists, k, &combined);
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s %9.3f ms  (%zu nodes)\n", method ? "DSL_MergeK" : "pop and insert", elapsed * 1e3, combined.length);
+	}
+	free(nodes);
+}
+
+#define ORGANIZE_NODES 4096
+#define ORGANIZE_LOOKUPS 200000
+
+typedef struct OrganizedNode
+{
+	void* pData;
+	void* pNext;
+	void* pPrev;
+	size_t count;
+} OrganizedNode;
+
+/**
+ * @brief Runs skewed lookups on an unordered list under every self-organizing policy.
+ */
+void benchSelfOrganizing()
+{
+	printf("Skewed lookups: %d lookups on an unordered list of %d nodes\n", ORGANIZE_LOOKUPS, ORGANIZE_NODES);
+
+	OrganizedNode* nodes = malloc(sizeof(OrganizedNode) * ORGANIZE_NODES);
+	int* targets = malloc(sizeof(int) * ORGANIZE_LOOKUPS);
+	unsigned int seed = 99;
+	for (int i = 0; i < ORGANIZE_LOOKUPS; i++)
+	{
+		// a high power of a uniform draw makes a few low ranks hot, the rank is scattered over the list
+		double u = (double)(nextRandom(&seed) % 1000000) / 1000000.0;
+		double skew = u * u * u;
+		int rank = (int)(skew * skew * ORGANIZE_NODES);
+		targets[i] = (int)(((unsigned int)rank * 2654435761u) % ORGANIZE_NODES);
+	}
+
+	const char* names[] = { "none", "move to front", "transpose", "count" };
+	for (int policy = DSL_ORGANIZE_NONE; policy <= DSL_ORGANIZE_COUNT; policy++)
+	{
+		DSL_List list;
+		DSL_InitList(0, offsetof(OrganizedNode, pNext), &list, NULL);
+		DSL_SetSelfOrganizing(&list, policy, offsetof(OrganizedNode, count));
+		// linked in a scattered order so every policy pays for pointer chasing, not just the reordered ones
+		for (int i = 0; i < ORGANIZE_NODES; i++)
+		{
+			int slot = (int)(((unsigned int)i * 2246822519u) % ORGANIZE_NODES);
+			nodes[slot] = (OrganizedNode){ &insertKeys[slot], NULL, NULL, 0 };
+			DSL_InsertNode(&nodes[slot], &list);
+		}
+
+		double start = now();
+		for (int i = 0; i < ORGANIZE_LOOKUPS; i++)
+		{
+			DSL_FindNode(&list, &insertKeys[targets[i]]);
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s average depth %8.1f  %7.3f us per lookup\n", names[policy], DSL_AverageScanDepth(&list),
+			   elapsed * 1e6 / ORGANIZE_LOOKUPS);
+	}
+	free(targets);
+	free(nodes);
+}
+
+/**
+ * @brief Compares intersecting two ordered lists by nested lookups against DSL_Intersect.
+ */
+void benchSetOperations()
+{
+	const size_t count = INSERTS_PER_RUN / 2;
+	printf("Intersect two ordered lists of %zu nodes\n", count);
+
+	// both lists refer to the same keys, every other key of pA is also in pB
+	DSL_Node* nodesA = malloc(sizeof(DSL_Node) * count);
+	DSL_Node* nodesB = malloc(sizeof(DSL_Node) * count);
+	for (int method = 0; method < 2; method++)
+	{
+		DSL_List listA, listB;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &listA, orderByKey);
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &listB, orderByKey);
+		DSL_SetDeferredOrder(&listA, 1);
+		DSL_SetDeferredOrder(&listB, 1);
+		for (size_t i = 0; i < count; i++)
+		{
+			DSL_InitNode(0, &nodesA[i], &insertKeys[i]);
+			DSL_InitNode(0, &nodesB[i], &insertKeys[(i % 2) ? count + i : i]);
+			DSL_InsertNode(&nodesA[i], &listA);
+			DSL_InsertNode(&nodesB[i], &listB);
+		}
+		DSL_SettleOrder(&listA);
+		DSL_SettleOrder(&listB);
+
+		double start = now();
+		if (method == 0)
+		{
+			for (DSL_Node* pNode = listA.pHead; pNode;)
+			{
+				DSL_Node* pNext = pNode->pNext;
+				if (!DSL_FindNode(&listB, pNode->pData))
+					DSL_RemoveNode(pNode, &listA);
+				pNode = pNext;
+			}
+		}
+		else
+		{
+			DSL_Intersect(&listA, &listB, NULL);
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s %9.3f ms  (%zu left)\n", method ? "DSL_Intersect" : "nested lookups", elapsed * 1e3, listA.length);
+	}
+	free(nodesB);
+	free(nodesA);
+}
+
+volatile size_t workloadSink;
+
+/**
+ * @brief Times one sorted vector workload against the same workload on a list.
+ *
+ * Workload 0 finds random nodes, 1 inserts and removes a node with a random key, and 2
+ * removes a random node it holds and appends it again with a key larger than all others.
+ */
+double timeOrderedWorkload(DSL_Node* nodes, int* keys, size_t length, int useVector, int workload)
+{
+	const int operations = 50000;
+	DSL_List list;
+	DSL_SortedVector vector;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderByKey);
+	DSL_InitSortedVector(&vector, orderByKey, length + 1);
+	for (size_t i = 0; i < length; i++)
+	{
+		keys[i] = (int)i;
+		DSL_InitNode(0, &nodes[i], &keys[i]);
+		if (useVector)
+			DSL_VectorInsert(&vector, &nodes[i]);
+		else
+			DSL_InsertNode(&nodes[i], &list);
+	}
+
+	unsigned int seed = 5;
+	size_t found = 0;
+	double start = now();
+	for (int i = 0; i < operations; i++)
+	{
+		DSL_Node* pNode = &nodes[nextRandom(&seed) % length];
+		if (workload == 0)
+		{
+			found += (useVector ? DSL_VectorFind(&vector, pNode) : (void*)DSL_FindNode(&list, pNode->pData)) != NULL;
+		}
+		else if (workload == 1)
+		{
+			DSL_Node* pExtra = &nodes[length];
+			keys[length] = (int)(nextRandom(&seed) % length);
+			DSL_InitNode(0, pExtra, &keys[length]);
+			if (useVector)
+			{
+				DSL_VectorInsert(&vector, pExtra);
+				DSL_VectorRemove(&vector, pExtra);
+			}
+			else
+			{
+				DSL_InsertNode(pExtra, &list);
+				DSL_RemoveNode(pExtra, &list);
+			}
+		}
+		else
+		{
+			if (useVector)
+				DSL_VectorRemove(&vector, pNode);
+			else
+				DSL_RemoveNode(pNode, &list);
+			*(int*)pNode->pData = (int)length + i;
+			if (useVector)
+				DSL_VectorInsert(&vector, pNode);
+			else
+				DSL_InsertNode(pNode, &list);
+		}
+	}
+	double elapsed = now() - start;
+
+	DSL_DestroySortedVector(&vector);
+	workloadSink += found;
+	return elapsed * 1e9 / operations;
+}
+
+/**
+ * @brief Finds the crossover between DSL_List and DSL_SortedVector for each workload.
+ */
+void benchSortedVector()
+{
+	printf("Sorted vector vs list: ns per operation\n");
+	printf("  %8s %22s %22s %22s\n", "", "find", "insert+remove", "remove+append");
+	printf("  %8s %11s %10s %11s %10s %11s %10s\n", "length", "list", "vector", "list", "vector", "list", "vector");
+
+	DSL_Node* nodes = malloc(sizeof(DSL_Node) * (INSERTS_PER_RUN + 1));
+	int* keys = malloc(sizeof(int) * (INSERTS_PER_RUN + 1));
+	timeOrderedWorkload(nodes, keys, 16, 1, 1);
+	for (size_t length = 16; length <= INSERTS_PER_RUN; length *= 4)
+	{
+		printf("  %8zu", length);
+		for (int workload = 0; workload < 3; workload++)
+		{
+			printf(" %11.1f %10.1f", timeOrderedWorkload(nodes, keys, length, 0, workload),
+				   timeOrderedWorkload(nodes, keys, length, 1, workload));
+		}
+		printf("\n");
+	}
+
+	// read-heavy and churn-heavy phases alternate, the adaptive list follows them
+	const size_t length = 2048;
+	const int phaseOperations = 50000;
+	printf("Alternating phases on %zu nodes: finds, remove+append, finds, remove+append\n", length);
+	const char* names[] = { "list", "vector", "adaptive" };
+	for (int mode = 0; mode < 3; mode++)
+	{
+		DSL_List list;
+		DSL_SortedVector vector;
+		DSL_AdaptiveList adaptive;
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderByKey);
+		DSL_InitSortedVector(&vector, orderByKey, length);
+		DSL_InitAdaptiveList(&adaptive, OFFSETOF_DSL_NODE, orderByKey, 0);
+		for (size_t i = 0; i < length; i++)
+		{
+			keys[i] = (int)i;
+			DSL_InitNode(0, &nodes[i], &keys[i]);
+			if (mode == 0)
+				DSL_InsertNode(&nodes[i], &list);
+			else if (mode == 1)
+				DSL_VectorInsert(&vector, &nodes[i]);
+			else
+				DSL_AdaptiveInsert(&nodes[i], &adaptive);
+		}
+
+		unsigned int seed = 17;
+		int nextKey = (int)length;
+		double start = now();
+		for (int phase = 0; phase < 4; phase++)
+		{
+			for (int i = 0; i < phaseOperations; i++)
+			{
+				DSL_Node* pNode = &nodes[nextRandom(&seed) % length];
+				if (phase % 2 == 0)
+				{
+					void* pFound = mode == 0 ? (void*)DSL_FindNode(&list, pNode->pData)
+											 : mode == 1 ? DSL_VectorFind(&vector, pNode) : DSL_AdaptiveFind(&adaptive, pNode);
+					workloadSink += pFound != NULL;
+					continue;
+				}
+
+				if (mode == 0)
+					DSL_RemoveNode(pNode, &list);
+				else if (mode == 1)
+					DSL_VectorRemove(&vector, pNode);
+				else
+					DSL_AdaptiveRemove(pNode, &adaptive);
+				*(int*)pNode->pData = nextKey++;
+				if (mode == 0)
+					DSL_InsertNode(pNode, &list);
+				else if (mode == 1)
+					DSL_VectorInsert(&vector, pNode);
+				else
+					DSL_AdaptiveInsert(pNode, &adaptive);
+			}
+		}
+		double elapsed = now() - start;
+
+		printf("  %-16s %9.3f ms", names[mode], elapsed * 1e3);
+		if (mode == 2)
+			printf("  (%zu switches)", adaptive.switches);
+		printf("\n");
+		DSL_DestroySortedVector(&vector);
+		DSL_DestroyAdaptiveList(&adaptive);
+	}
+
+	free(keys);
+	free(nodes);
+}
+
+int main()
+{
+	printf("Running benchmarks for DoubleSeaLib\n");
+	benchWorkStealing();
+	benchShardedInsert();
+	benchStaticStorageScan();
+	benchDeferredOrder();
+	benchArenaList();
+	benchFilteredLookup();
+	benchInlineFastPath();
+	benchSpillList();
+	benchMergeK();
+	benchSelfOrganizing();
+	benchSetOperations();
+	benchSortedVector();
+	return 0;
+}
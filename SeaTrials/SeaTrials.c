@@ -1,13 +1,76 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
+#include <string.h>
 #include "../DoubleSeaLib.h"
+#include "../DoubleSeaDeque.h"
+#include "../DoubleSeaPlatform.h"
+#include "../DoubleSeaShards.h"
+#include "../DoubleSeaInline.h"
+#include "../DoubleSeaSpill.h"
+#include "../DoubleSeaVector.h"
 
 typedef struct testData
 {
 	int number;
 } TestData;
 
+typedef struct testEntity
+{
+	void* pData;
+	void* pNext;
+	void* pPrev;
+	size_t index;
+	uint32_t generation;
+} TestEntity;
+
+typedef struct testPayloadEntity
+{
+	TestData payload;
+	void* pData;
+	void* pNext;
+	void* pPrev;
+} TestPayloadEntity;
+
+typedef struct testThief
+{
+	DSL_Deque* pDeque;
+	DSL_List stolen;
+	int64_t done;
+} TestThief;
+
+typedef struct testSpillItem
+{
+	DSL_Node node;
+	TestData data;
+} TestSpillItem;
+
+typedef struct testCountedNode
+{
+	void* pData;
+	void* pNext;
+	void* pPrev;
+	size_t count;
+} TestCountedNode;
+
 int orderFunction(void* pNode1, void* pNode2);
+int isEvenPredicate(void* pNode, void* pCtx);
+void countingDestructor(void* pNode, void* pCtx);
+void recordRelocation(void* pOldNode, void* pNewNode, void* pCtx);
+size_t numberShard(void* pNode);
+int collectNumbers(void* pNode, void* pCtx);
+size_t serializeSpillItem(void* pNode, void* pBuffer, size_t bufferSize, void* pCtx);
+void* deserializeSpillItem(const void* pBuffer, size_t size, void* pCtx);
+void freeSpillItem(void* pNode, void* pCtx);
+void* failDeserialize(const void* pBuffer, size_t size, void* pCtx);
+void stealUntilDone(TestThief* pThief);
+#ifdef _WIN32
+DWORD WINAPI thiefMain(LPVOID pThief);
+#else
+void* thiefMain(void* pThief);
+#endif
+void buildNumberList(DSL_List* pList, const int* numbers, int count, TestData* values, DSL_Node* nodes);
+void assertNumbers(DSL_List* pList, const int* numbers, int count);
 int compareFunction(void* pNode1, void* pNode2, size_t offset);
 void testInitDoublyLinkedList();
 void testInitDoublyLinkedNode();
@@ -18,6 +81,23 @@ void testRemoveNode();
 void testPushNode();
 void testPopNode();
 void testFindNode();
+void testSlotMap();
+void testRemoveIf();
+void testDestroyListEx();
+void testCompact();
+void testDeque();
+void testShardedList();
+void testStaticStorageScan();
+void testDeferredOrder();
+void testArenaList();
+void testFilter();
+void testFindNodeBatch();
+void testInlineFastPath();
+void testSpillList();
+void testMergeK();
+void testSelfOrganizing();
+void testSetOperations();
+void testSortedVector();
 
 void (*testFunctions[])() = {
 	testInitDoublyLinkedList,
@@ -28,7 +108,24 @@ void (*testFunctions[])() = {
 	testRemoveNode,
 	testPushNode,
 	testPopNode,
-	testFindNode };
+	testFindNode,
+	testSlotMap,
+	testRemoveIf,
+	testDestroyListEx,
+	testCompact,
+	testDeque,
+	testShardedList,
+	testStaticStorageScan,
+	testDeferredOrder,
+	testArenaList,
+	testFilter,
+	testFindNodeBatch,
+	testInlineFastPath,
+	testSpillList,
+	testMergeK,
+	testSelfOrganizing,
+	testSetOperations,
+	testSortedVector };
 
 TestData testNumbers[5] = { {1}, {2}, {3}, {4}, {5} };
 DSL_List testList = { 0, 0, 0, 0, OFFSETOF_DSL_NODE, orderFunction };
@@ -37,6 +134,7 @@ DSL_Node nodeBucket[5] = { {&testNumbers[0], NULL, NULL, 0},
 						  {&testNumbers[2], NULL, NULL, 0},
 						  {&testNumbers[3], NULL, NULL, 0},
 						  {&testNumbers[4], NULL, NULL, 0} };
+size_t spillRecordsWritten = 0;
 
 int main()
 {
@@ -102,6 +200,177 @@ int orderFunction(void* pNode1, void* pNode2)
 	return data1->number - data2->number;
 }
 
+/**
+ * @brief Predicate that matches nodes holding an even number.
+ *
+ * @param pNode The node to test.
+ * @param pCtx Unused.
+ *
+ * @return 1 if the number is even, 0 otherwise.
+ */
+int isEvenPredicate(void* pNode, void* pCtx)
+{
+	return ((TestData*)((DSL_Node*)pNode)->pData)->number % 2 == 0;
+}
+
+/**
+ * @brief Destructor that counts the entities it is called with.
+ *
+ * @param pNode The node being destroyed, the start of a TestPayloadEntity.
+ * @param pCtx A pointer to an int counter.
+ */
+void countingDestructor(void* pNode, void* pCtx)
+{
+	TestPayloadEntity* entity = (TestPayloadEntity*)pNode;
+	assert(entity->payload.number == 7);
+	assert(entity->pNext == NULL && entity->pPrev == NULL);
+	(*(int*)pCtx)++;
+}
+
+/**
+ * @brief Relocate callback that records where each node moved.
+ *
+ * @param pOldNode The node's old address.
+ * @param pNewNode The node's new address.
+ * @param pCtx An array of DSL_Node pointers indexed by the node's number.
+ */
+void recordRelocation(void* pOldNode, void* pNewNode, void* pCtx)
+{
+	DSL_Node** moved = (DSL_Node**)pCtx;
+	moved[((TestData*)((DSL_Node*)pNewNode)->pData)->number - 1] = pNewNode;
+}
+
+/**
+ * @brief Shard function that spreads nodes by their number.
+ *
+ * @param pNode The node being inserted.
+ *
+ * @return The node's number.
+ */
+size_t numberShard(void* pNode)
+{
+	return (size_t)((TestData*)((DSL_Node*)pNode)->pData)->number;
+}
+
+/**
+ * @brief Visitor that appends each node's number to an int array.
+ *
+ * @param pNode The node being visited.
+ * @param pCtx An int array whose first element is the number of values written.
+ *
+ * @return 1 to keep visiting.
+ */
+int collectNumbers(void* pNode, void* pCtx)
+{
+	int* numbers = (int*)pCtx;
+	numbers[++numbers[0]] = ((TestData*)((DSL_Node*)pNode)->pData)->number;
+	return 1;
+}
+
+/**
+ * @brief Writes the number of a TestSpillItem and counts the records written.
+ */
+size_t serializeSpillItem(void* pNode, void* pBuffer, size_t bufferSize, void* pCtx)
+{
+	if (bufferSize >= sizeof(TestData))
+	{
+		memcpy(pBuffer, &((TestSpillItem*)pNode)->data, sizeof(TestData));
+		spillRecordsWritten++;
+	}
+	return sizeof(TestData);
+}
+
+/**
+ * @brief Allocates a TestSpillItem for a number written by serializeSpillItem.
+ */
+void* deserializeSpillItem(const void* pBuffer, size_t size, void* pCtx)
+{
+	assert(size == sizeof(TestData));
+	TestSpillItem* pItem = malloc(sizeof(TestSpillItem));
+	memcpy(&pItem->data, pBuffer, sizeof(TestData));
+	DSL_InitNode(1, &pItem->node, &pItem->data);
+	return pItem;
+}
+
+/**
+ * @brief Frees a TestSpillItem and counts it.
+ */
+void freeSpillItem(void* pNode, void* pCtx)
+{
+	(*(int*)pCtx)++;
+	free(pNode);
+}
+
+/**
+ * @brief Fails to rebuild any node, like a DeserializeFunction that runs out of memory.
+ */
+void* failDeserialize(const void* pBuffer, size_t size, void* pCtx)
+{
+	return NULL;
+}
+
+/**
+ * @brief Steals from a deque into the thief's own list until the owner is done and the deque is empty.
+ */
+void stealUntilDone(TestThief* pThief)
+{
+	while (1)
+	{
+		int done = DSL_LoadAcquire64(&pThief->done) != 0;
+		void* pNode = DSL_DequeSteal(pThief->pDeque);
+		if (pNode)
+			DSL_Push(pNode, &pThief->stolen);
+		else if (done && DSL_DequeSize(pThief->pDeque) == 0)
+			return;
+	}
+}
+
+#ifdef _WIN32
+DWORD WINAPI thiefMain(LPVOID pThief)
+{
+	stealUntilDone(pThief);
+	return 0;
+}
+#else
+void* thiefMain(void* pThief)
+{
+	stealUntilDone(pThief);
+	return NULL;
+}
+#endif
+
+/**
+ * @brief Builds an ordered list of the given numbers, TestData and DSL_Node storage come from the caller.
+ */
+void buildNumberList(DSL_List* pList, const int* numbers, int count, TestData* values, DSL_Node* nodes)
+{
+	DSL_InitList(0, OFFSETOF_DSL_NODE, pList, orderFunction);
+	for (int i = 0; i < count; i++)
+	{
+		values[i].number = numbers[i];
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_InsertNode(&nodes[i], pList);
+	}
+}
+
+/**
+ * @brief Checks that a list holds exactly the given numbers in order with intact links.
+ */
+void assertNumbers(DSL_List* pList, const int* numbers, int count)
+{
+	assert(pList->length == (size_t)count);
+	DSL_Node* node = pList->pHead;
+	DSL_Node* prev = NULL;
+	for (int i = 0; i < count; i++)
+	{
+		assert(node->pPrev == prev);
+		assert(((TestData*)node->pData)->number == numbers[i]);
+		prev = node;
+		node = node->pNext;
+	}
+	assert(node == NULL && pList->pTail == prev);
+}
+
 void testInitDoublyLinkedList()
 {
 	DSL_List list;
@@ -241,3 +510,1087 @@ void testFindNode()
 	}
 	printf("  Test 9 - Find Node - passed\n");
 }
+
+void testSlotMap()
+{
+	TestEntity entities[4];
+	DSL_SlotMap map;
+	DSL_InitSlotMapArgs args = { entities, offsetof(TestEntity, pNext), 4, &map,
+								 sizeof(TestEntity), offsetof(TestEntity, index), offsetof(TestEntity, generation) };
+	DSL_InitSlotMap(&args);
+	assert(map.freeList.length == 4);
+
+	// allocate every slot
+	DSL_Handle handles[4];
+	for (int i = 0; i < 4; i++)
+	{
+		TestEntity* entity = DSL_SlotMapAlloc(&map, &handles[i]);
+		assert(entity == &entities[i]);
+		assert(DSL_HANDLE_INDEX(handles[i]) == (size_t)i);
+		assert(DSL_SlotMapGet(&map, handles[i]) == entity);
+		assert(DSL_SlotMapHandleOf(&map, entity) == handles[i]);
+	}
+
+	// the map is full
+	DSL_Handle full;
+	assert(DSL_SlotMapAlloc(&map, &full) == NULL);
+	assert(full == DSL_INVALID_HANDLE);
+	assert(DSL_SlotMapGet(&map, DSL_INVALID_HANDLE) == NULL);
+
+	// freeing makes the handle stale and the slot reusable
+	assert(DSL_SlotMapFree(&map, handles[2]) == 1);
+	assert(DSL_SlotMapGet(&map, handles[2]) == NULL);
+	assert(DSL_SlotMapHandleOf(&map, &entities[2]) == DSL_INVALID_HANDLE);
+	assert(DSL_SlotMapFree(&map, handles[2]) == 0);
+
+	DSL_Handle reused;
+	assert(DSL_SlotMapAlloc(&map, &reused) == &entities[2]);
+	assert(reused != handles[2]);
+	assert(DSL_HANDLE_INDEX(reused) == 2);
+	assert(DSL_SlotMapGet(&map, handles[2]) == NULL);
+	assert(DSL_SlotMapGet(&map, reused) == &entities[2]);
+	printf("  Test 10 - Slot Map - passed\n");
+}
+
+void testRemoveIf()
+{
+	DSL_List list;
+	DSL_List removed;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderFunction);
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &removed, NULL);
+
+	DSL_Node nodes[5];
+	for (int i = 0; i < 5; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &testNumbers[i]);
+		DSL_InsertNode(&nodes[i], &list);
+	}
+
+	// 2 and 4 are removed, in list order
+	assert(DSL_RemoveIf(&list, isEvenPredicate, NULL, &removed) == 2);
+	assert(list.length == 3);
+	assert(list.pHead == &nodes[0]);
+	assert(list.pTail == &nodes[4]);
+	assert(nodes[0].pNext == &nodes[2] && nodes[2].pPrev == &nodes[0]);
+	assert(nodes[2].pNext == &nodes[4] && nodes[4].pPrev == &nodes[2]);
+	assert(removed.length == 2);
+	assert(removed.pHead == &nodes[1] && removed.pTail == &nodes[3]);
+	assert(nodes[1].pNext == &nodes[3] && nodes[3].pPrev == &nodes[1]);
+
+	// nothing left to match
+	assert(DSL_RemoveIf(&list, isEvenPredicate, NULL, NULL) == 0);
+	assert(list.length == 3);
+	printf("  Test 11 - Remove If - passed\n");
+}
+
+void testDestroyListEx()
+{
+	// a custom intrusive struct with a leading payload, the links are not at the DSL_Node offsets
+	TestPayloadEntity entities[3];
+	DSL_List list;
+	assert(offsetof(TestPayloadEntity, pNext) != OFFSETOF_DSL_NODE);
+	DSL_InitList(0, offsetof(TestPayloadEntity, pNext), &list, NULL);
+	for (int i = 0; i < 3; i++)
+	{
+		entities[i].payload.number = 7;
+		entities[i].pData = &entities[i].payload;
+		DSL_InsertNode(&entities[i], &list);
+	}
+
+	int destroyed = 0;
+	DSL_DestroyListEx(&list, countingDestructor, &destroyed);
+	assert(destroyed == 3);
+	assert(list.length == 0 && list.pHead == NULL && list.pTail == NULL);
+	assert(list.offset == offsetof(TestPayloadEntity, pNext));
+
+	// dynamic nodes are freed by DSL_DestroyList
+	DSL_List* dynamicList = malloc(sizeof(DSL_List));
+	DSL_InitList(1, OFFSETOF_DSL_NODE, dynamicList, NULL);
+	for (int i = 0; i < 3; i++)
+	{
+		DSL_Node* node = malloc(sizeof(DSL_Node));
+		DSL_InitNode(1, node, &testNumbers[i]);
+		DSL_Push(node, dynamicList);
+	}
+	DSL_DestroyList(dynamicList, 1);
+	printf("  Test 12 - Destroy List Ex - passed\n");
+}
+
+void testCompact()
+{
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderFunction);
+
+	// insert out of order so the heap order differs from the list order
+	int order[5] = { 3, 0, 4, 1, 2 };
+	for (int i = 0; i < 5; i++)
+	{
+		DSL_Node* node = malloc(sizeof(DSL_Node));
+		DSL_InitNode(1, node, &testNumbers[order[i]]);
+		DSL_InsertNode(node, &list);
+	}
+
+	DSL_Node* moved[5] = { 0 };
+	for (int pass = 0; pass < 2; pass++)
+	{
+		assert(DSL_CompactNodes(&list, recordRelocation, moved) == 1);
+		assert(list.length == 5);
+
+		DSL_Node* block = list.pBlock;
+		DSL_Node* node = list.pHead;
+		for (int i = 0; i < 5; i++)
+		{
+			// nodes sit next to each other in list order
+			assert(node == &block[i]);
+			assert(moved[i] == node);
+			assert(node->pData == &testNumbers[i]);
+			assert(node->dynamic == 0);
+			assert(node->pPrev == (i == 0 ? NULL : &block[i - 1]));
+			node = node->pNext;
+		}
+		assert(node == NULL);
+		assert(list.pTail == &block[4]);
+	}
+
+	// the list keeps working, an unlinked node still lives in the block until it is copied out
+	DSL_Node* block = list.pBlock;
+	DSL_RemoveNode(moved[2], &list);
+	assert(list.length == 4);
+	assert(moved[2] == &block[2]);
+	DSL_Node removed = *moved[2];
+	assert(*DSL_FindNode(&list, &testNumbers[3]) == moved[3]);
+	assert(DSL_CompactNodes(&list, NULL, NULL) == 1);
+	assert(list.pBlock != block && removed.pData == &testNumbers[2]);
+	DSL_DestroyList(&list, 1);
+	assert(list.pBlock == NULL);
+
+	// non-dynamic originals belong to the caller and are left as they were
+	DSL_Node nodes[3];
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderFunction);
+	for (int i = 0; i < 3; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &testNumbers[i]);
+		DSL_InsertNode(&nodes[i], &list);
+	}
+	assert(DSL_CompactNodes(&list, NULL, NULL) == 1);
+	assert(list.pHead == list.pBlock);
+	for (int i = 0; i < 3; i++)
+	{
+		assert(nodes[i].pData == &testNumbers[i]);
+	}
+	DSL_DestroyList(&list, 1);
+
+	// other structs are copied as they are, even when their layout matches DSL_Node
+	TestCountedNode counted[3];
+	size_t offset = offsetof(TestCountedNode, pNext);
+	assert(sizeof(TestCountedNode) == sizeof(DSL_Node) && offset == OFFSETOF_DSL_NODE);
+	DSL_InitList(0, offset, &list, NULL);
+	for (int i = 0; i < 3; i++)
+	{
+		counted[i].pData = &testNumbers[i];
+		counted[i].count = 1;
+		DSL_Push(&counted[i], &list);
+	}
+	assert(DSL_Compact(&list, sizeof(TestCountedNode), NULL, NULL) == 1);
+	TestCountedNode* copy = list.pHead;
+	for (int i = 0; i < 3; i++)
+	{
+		assert(counted[i].count == 1 && copy[i].count == 1);
+	}
+	DSL_DestroyListEx(&list, NULL, NULL);
+
+	// DSL_CompactNodes only takes lists of DSL_Node
+	TestPayloadEntity entity = { {7} };
+	DSL_InitList(0, offsetof(TestPayloadEntity, pNext), &list, NULL);
+	DSL_Push(&entity, &list);
+	assert(DSL_CompactNodes(&list, NULL, NULL) == 0 && list.pBlock == NULL && list.pHead == &entity);
+	DSL_DestroyListEx(&list, NULL, NULL);
+	printf("  Test 13 - Compact - passed\n");
+}
+
+void testDeque()
+{
+	DSL_Deque deque;
+	assert(DSL_InitDeque(&deque, OFFSETOF_DSL_NODE, 1) == 1);
+	assert(DSL_DequePop(&deque) == NULL);
+	assert(DSL_DequeSteal(&deque) == NULL);
+
+	// push enough to force the buffer to grow
+	DSL_Node nodes[40];
+	for (int i = 0; i < 40; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &testNumbers[i % 5]);
+		assert(DSL_DequePush(&deque, &nodes[i]) == 1);
+	}
+	assert(DSL_DequeSize(&deque) == 40);
+
+	// the owner pops newest first, thieves take oldest first
+	assert(DSL_DequePop(&deque) == &nodes[39]);
+	assert(DSL_DequeSteal(&deque) == &nodes[0]);
+	assert(DSL_DequeSteal(&deque) == &nodes[1]);
+	assert(DSL_DequePop(&deque) == &nodes[38]);
+	assert(DSL_DequeSize(&deque) == 36);
+
+	for (int i = 37; i >= 2; i--)
+	{
+		assert(DSL_DequePop(&deque) == &nodes[i]);
+	}
+	assert(DSL_DequePop(&deque) == NULL);
+	assert(DSL_DequeSteal(&deque) == NULL);
+
+	// a list moves in head first
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+	for (int i = 0; i < 3; i++)
+	{
+		DSL_InsertNode(&nodes[i], &list);
+	}
+	assert(DSL_DequePushList(&deque, &list) == 3);
+	assert(list.length == 0);
+	assert(DSL_DequeSteal(&deque) == &nodes[0]);
+	assert(DSL_DequePop(&deque) == &nodes[2]);
+	assert(DSL_DequePop(&deque) == &nodes[1]);
+
+	// a thief steals while lists are pushed, every node ends up in exactly one list
+	enum { ROUNDS = 200, BATCH = 40 };
+	DSL_Node* batch = malloc(sizeof(DSL_Node) * ROUNDS * BATCH);
+	char* seen = calloc(ROUNDS * BATCH, 1);
+	TestThief thief = { &deque };
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &thief.stolen, NULL);
+	DSL_List kept;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &kept, NULL);
+#ifdef _WIN32
+	HANDLE thread = CreateThread(NULL, 0, thiefMain, &thief, 0, NULL);
+#else
+	pthread_t thread;
+	pthread_create(&thread, NULL, thiefMain, &thief);
+#endif
+	size_t pushed = 0;
+	for (int round = 0; round < ROUNDS; round++)
+	{
+		for (int i = 0; i < BATCH; i++)
+		{
+			DSL_Node* node = &batch[(round * BATCH) + i];
+			DSL_InitNode(0, node, &testNumbers[i % 5]);
+			DSL_InsertNode(node, &list);
+		}
+		pushed += DSL_DequePushList(&deque, &list);
+		assert(list.length == 0 && list.pHead == NULL);
+
+		// the owner keeps some work for itself, like a scheduler would
+		for (int i = 0; i < BATCH / 4; i++)
+		{
+			void* pNode = DSL_DequePop(&deque);
+			if (pNode)
+				DSL_Push(pNode, &kept);
+		}
+	}
+	void* pNode;
+	while ((pNode = DSL_DequePop(&deque)) != NULL)
+		DSL_Push(pNode, &kept);
+	DSL_StoreRelease64(&thief.done, 1);
+#ifdef _WIN32
+	WaitForSingleObject(thread, INFINITE);
+	CloseHandle(thread);
+#else
+	pthread_join(thread, NULL);
+#endif
+
+	assert(pushed == ROUNDS * BATCH);
+	assert(kept.length + thief.stolen.length == pushed);
+	DSL_List* owners[2] = { &kept, &thief.stolen };
+	for (int l = 0; l < 2; l++)
+	{
+		size_t count = 0;
+		DSL_Node* prev = NULL;
+		for (DSL_Node* node = owners[l]->pHead; node; node = node->pNext)
+		{
+			assert(node->pPrev == prev);
+			assert(seen[node - batch]++ == 0);
+			prev = node;
+			count++;
+		}
+		assert(count == owners[l]->length && owners[l]->pTail == prev);
+	}
+	free(seen);
+	free(batch);
+
+	DSL_DestroyDeque(&deque);
+	printf("  Test 14 - Work Stealing Deque - passed\n");
+}
+
+void testShardedList()
+{
+	DSL_ShardedList sharded;
+	assert(DSL_InitShardedList(&sharded, 3, OFFSETOF_DSL_NODE, NULL, numberShard) == 0);
+	assert(DSL_InitShardedList(&sharded, 3, OFFSETOF_DSL_NODE, orderFunction, numberShard) == 1);
+
+	DSL_Node nodes[5];
+	size_t shards[5];
+	int order[5] = { 3, 0, 4, 1, 2 };
+	for (int i = 0; i < 5; i++)
+	{
+		int n = order[i];
+		DSL_InitNode(0, &nodes[n], &testNumbers[n]);
+		shards[n] = DSL_ShardedInsert(&nodes[n], &sharded);
+		assert(shards[n] == DSL_ShardOf(&sharded, &nodes[n]));
+	}
+	assert(DSL_ShardedLength(&sharded) == 5);
+
+	// iteration merges the shards into one order
+	int numbers[6] = { 0 };
+	DSL_ShardedForEach(&sharded, collectNumbers, numbers);
+	assert(numbers[0] == 5);
+	for (int i = 1; i <= 5; i++)
+	{
+		assert(numbers[i] == i);
+	}
+
+	DSL_ShardedRemove(&nodes[2], &sharded, shards[2]);
+	assert(DSL_ShardedLength(&sharded) == 4);
+
+	// draining relinks everything into one ordered list
+	DSL_List drained;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &drained, orderFunction);
+	assert(DSL_ShardedDrain(&sharded, &drained) == 4);
+	assert(DSL_ShardedLength(&sharded) == 0);
+	assert(drained.length == 4);
+	int expected[4] = { 0, 1, 3, 4 };
+	DSL_Node* node = drained.pHead;
+	for (int i = 0; i < 4; i++)
+	{
+		assert(node == &nodes[expected[i]]);
+		assert(node->pPrev == (i == 0 ? NULL : &nodes[expected[i - 1]]));
+		node = node->pNext;
+	}
+	assert(drained.pTail == &nodes[4]);
+
+	// a destination with deferred ordering sorts the drained nodes on its next ordered read
+	DSL_List deferred;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &deferred, orderFunction);
+	DSL_SetDeferredOrder(&deferred, 1);
+	for (int i = 0; i < 4; i++)
+	{
+		DSL_RemoveNode(&nodes[expected[i]], &drained);
+		DSL_ShardedInsert(&nodes[expected[i]], &sharded);
+	}
+	DSL_InsertNode(&nodes[2], &deferred);
+	DSL_SettleOrder(&deferred);
+	assert(DSL_ShardedDrain(&sharded, &deferred) == 4);
+	assert(deferred.pPending == &nodes[0]);
+	for (int i = 0; i < 5; i++)
+	{
+		assert(DSL_Pop(&deferred) == &nodes[i]);
+	}
+
+	// an ordered destination that already holds nodes stays in order
+	for (int i = 0; i < 4; i++)
+	{
+		DSL_ShardedInsert(&nodes[expected[i]], &sharded);
+	}
+	DSL_InsertNode(&nodes[2], &drained);
+	assert(DSL_ShardedDrain(&sharded, &drained) == 4);
+	assert(drained.length == 5 && drained.pTail == &nodes[4]);
+	node = drained.pHead;
+	for (int i = 0; i < 5; i++)
+	{
+		assert(node == &nodes[i]);
+		assert(node->pPrev == (i == 0 ? NULL : &nodes[i - 1]));
+		node = node->pNext;
+	}
+
+	DSL_DestroyShardedList(&sharded, NULL, NULL);
+	printf("  Test 15 - Sharded List - passed\n");
+}
+
+void testStaticStorageScan()
+{
+	// enough entries to run the vector loops and their remainders
+	TestEntity entities[37];
+	DSL_List list;
+	DSL_InitList(0, offsetof(TestEntity, pNext), &list, NULL);
+	DSL_InitStaticStorageListArgs args = { entities, offsetof(TestEntity, pNext), 37, &list,
+										   sizeof(TestEntity), offsetof(TestEntity, index), NULL };
+	DSL_InitStaticStorageListWData(&args);
+
+	for (int i = 0; i < 37; i++)
+	{
+		entities[i].pData = &entities[36 - i];
+		entities[i].generation = (uint32_t)(i * 3);
+	}
+
+	for (int i = 0; i < 37; i++)
+	{
+		assert(DSL_FindStaticStorageNode(&args, &entities[36 - i]) == &entities[i]);
+		assert(DSL_FindStaticStorageKey(&args, offsetof(TestEntity, generation), 4, i * 3) == &entities[i]);
+		assert(DSL_FindStaticStorageKey(&args, offsetof(TestEntity, index), sizeof(size_t), i) == &entities[i]);
+	}
+	assert(DSL_FindStaticStorageNode(&args, &testNumbers[0]) == NULL);
+	assert(DSL_FindStaticStorageKey(&args, offsetof(TestEntity, generation), 4, 1) == NULL);
+	assert(DSL_FindStaticStorageKey(&args, offsetof(TestEntity, generation), 2, 0) == NULL);
+
+	// densely packed keys take the contiguous load path
+	int keys[37];
+	for (int i = 0; i < 37; i++)
+	{
+		keys[i] = 100 + i;
+	}
+	DSL_InitStaticStorageListArgs keyArgs = { keys, 0, 37, NULL, sizeof(int), 0, NULL };
+	for (int i = 0; i < 37; i++)
+	{
+		assert(DSL_FindStaticStorageKey(&keyArgs, 0, sizeof(int), 100 + i) == &keys[i]);
+	}
+	assert(DSL_FindStaticStorageKey(&keyArgs, 0, sizeof(int), 99) == NULL);
+	printf("  Test 16 - Static Storage Scan - passed\n");
+}
+
+void testDeferredOrder()
+{
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, orderFunction);
+	DSL_SetDeferredOrder(&list, 1);
+
+	// duplicates of 2 and 4 check that equal keys keep their insertion order
+	TestData values[9] = { {4}, {2}, {5}, {1}, {3}, {2}, {4}, {0}, {6} };
+	DSL_Node nodes[9];
+	for (int i = 0; i < 9; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_InsertNode(&nodes[i], &list);
+		// appended in O(1), nothing has been ordered yet
+		assert(list.pTail == &nodes[i]);
+	}
+	assert(list.length == 9);
+	assert(list.pPending == &nodes[1]);
+
+	// the first pop settles the list
+	assert(DSL_Pop(&list) == &nodes[7]);
+	assert(list.pPending == NULL);
+	int expected[8] = { 3, 1, 5, 4, 0, 6, 2, 8 };
+	DSL_Node* node = list.pHead;
+	for (int i = 0; i < 8; i++)
+	{
+		assert(node == &nodes[expected[i]]);
+		assert(node->pPrev == (i == 0 ? NULL : &nodes[expected[i - 1]]));
+		node = node->pNext;
+	}
+	assert(list.pTail == &nodes[8]);
+
+	// a later batch merges into the ordered part
+	TestData more[3] = { {7}, {-1}, {3} };
+	DSL_Node moreNodes[3];
+	for (int i = 0; i < 3; i++)
+	{
+		DSL_InitNode(0, &moreNodes[i], &more[i]);
+		DSL_InsertNode(&moreNodes[i], &list);
+	}
+	DSL_RemoveNode(&moreNodes[0], &list);
+	assert(list.pPending == &moreNodes[1]);
+	assert(*DSL_FindNode(&list, &more[2]) == &moreNodes[2]);
+	assert(list.pPending == NULL);
+	assert(list.pHead == &moreNodes[1]);
+	assert(nodes[0].pPrev == &moreNodes[2] && moreNodes[2].pPrev == &nodes[4]);
+
+	// misses walk to the end and stop
+	assert(DSL_FindNode(&list, &more[0]) == NULL);
+
+	// turning deferral off goes back to ordered inserts
+	DSL_SetDeferredOrder(&list, 0);
+	DSL_InsertNode(&moreNodes[0], &list);
+	assert(list.pTail == &moreNodes[0]);
+	assert(list.pPending == NULL);
+	printf("  Test 17 - Deferred Order - passed\n");
+}
+
+void testArenaList()
+{
+	DSL_List* list = malloc(sizeof(DSL_List));
+	DSL_InitList(1, OFFSETOF_DSL_NODE, list, orderFunction);
+	assert(DSL_ArenaAlloc(list, 8) == NULL);
+	assert(DSL_EnableArena(list, 256) == 1);
+
+	// nodes and payloads share the list's region
+	size_t blocks = 0;
+	for (int request = 0; request < 3; request++)
+	{
+		for (int i = 0; i < 100; i++)
+		{
+			TestData* data = DSL_ArenaAlloc(list, sizeof(TestData));
+			assert(data != NULL && ((size_t)data % DSL_ARENA_ALIGNMENT) == 0);
+			data->number = 100 - i;
+
+			DSL_Node* node = DSL_ArenaAllocNode(list, data);
+			assert(node != NULL && node->dynamic == 0);
+			DSL_InsertNode(node, list);
+		}
+		assert(list->length == 100);
+		assert(((TestData*)((DSL_Node*)list->pHead)->pData)->number == 1);
+
+		// later requests reuse the blocks of the first one
+		if (request == 0)
+			blocks = list->pArena->blockCount;
+		assert(list->pArena->blockCount == blocks);
+
+		DSL_ResetList(list);
+		assert(list->length == 0 && list->pHead == NULL && list->pTail == NULL);
+		assert(list->pArena->blockCount == blocks);
+		assert(list->orderFunction == orderFunction);
+	}
+
+	// allocations larger than a block get a block of their own
+	assert(DSL_ArenaAlloc(list, 1000) != NULL);
+
+	// the region is released as a whole, nodes from elsewhere are still cleaned up
+	DSL_Node* arenaNode = DSL_ArenaAllocNode(list, &testNumbers[0]);
+	arenaNode->dynamic = 1;
+	DSL_InsertNode(arenaNode, list);
+	DSL_Node* heapNode = malloc(sizeof(DSL_Node));
+	DSL_InitNode(1, heapNode, &testNumbers[1]);
+	DSL_InsertNode(heapNode, list);
+	DSL_Node staticNode;
+	DSL_InitNode(0, &staticNode, &testNumbers[2]);
+	DSL_InsertNode(&staticNode, list);
+	DSL_DestroyList(list, 1);
+	assert(staticNode.pData == NULL);
+	printf("  Test 18 - Arena List - passed\n");
+}
+
+void testFilter()
+{
+	TestData values[64];
+	DSL_Node nodes[64];
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+
+	// nodes already in the list are added when the filter is enabled
+	for (int i = 0; i < 32; i++)
+	{
+		values[i].number = i;
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_InsertNode(&nodes[i], &list);
+	}
+	assert(DSL_GetFilterStats(&list, &(DSL_FilterStats){ 0 }) == 0);
+	assert(DSL_EnableFilter(&list, 64, 0.01) == 1);
+	for (int i = 32; i < 64; i++)
+	{
+		values[i].number = i;
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_Push(&nodes[i], &list);
+	}
+
+	DSL_FilterStats stats;
+	assert(DSL_GetFilterStats(&list, &stats) == 1);
+	assert(stats.counterCount >= 613 && (stats.counterCount & (stats.counterCount - 1)) == 0);
+	assert(stats.hashCount >= 1 && stats.hashCount <= 16);
+	assert(stats.memoryBytes == sizeof(DSL_Filter) + stats.counterCount);
+	assert(stats.estimatedFalsePositiveRate > 0.0 && stats.estimatedFalsePositiveRate < 0.01);
+
+	// the answer is exact, false positives fall through to the scan
+	TestData absent[16];
+	for (int i = 0; i < 64; i++)
+		assert(DSL_Contains(&list, &values[i]) == 1);
+	for (int i = 0; i < 16; i++)
+		assert(DSL_Contains(&list, &absent[i]) == 0);
+	assert(DSL_GetFilterStats(&list, &stats) == 1);
+	assert(stats.definiteMisses + stats.falsePositives == 16);
+
+	// removals clear the counters again
+	for (int i = 0; i < 32; i++)
+		DSL_RemoveNode(&nodes[i], &list);
+	while (DSL_Pop(&list) != NULL)
+		;
+	assert(DSL_GetFilterStats(&list, &stats) == 1);
+	size_t misses = stats.definiteMisses + stats.falsePositives;
+	for (int i = 0; i < 64; i++)
+		assert(DSL_FindNode(&list, &values[i]) == NULL);
+	DSL_InsertNode(&nodes[0], &list);
+	for (int i = 1; i < 64; i++)
+		assert(DSL_Contains(&list, &values[i]) == 0);
+	assert(DSL_GetFilterStats(&list, &stats) == 1);
+	assert(stats.definiteMisses + stats.falsePositives == misses + 63);
+	assert(DSL_Contains(&list, &values[0]) == 1);
+
+	DSL_DisableFilter(&list);
+	assert(list.pFilter == NULL);
+	assert(DSL_Contains(&list, &values[0]) == 1);
+	printf("  Test 19 - Filter - passed\n");
+}
+
+void testFindNodeBatch()
+{
+	TestData values[40];
+	DSL_Node nodes[40];
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+	for (int i = 0; i < 40; i++)
+	{
+		values[i].number = i;
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_InsertNode(&nodes[i], &list);
+	}
+
+	// hits, misses, duplicates and the head and tail in one batch
+	TestData absent;
+	void* keys[8] = { &values[20], &absent, &values[0], &values[39], &values[20], NULL, &values[1], &values[38] };
+	void** results[8];
+	assert(DSL_FindNodeBatch(&list, keys, 8, results) == 6);
+	for (int i = 0; i < 8; i++)
+		assert(results[i] == DSL_FindNode(&list, keys[i]));
+	assert(results[2] == &list.pHead && results[3] == &list.pTail);
+	assert(results[0] == (void**)&nodes[19].pNext && results[4] == results[0]);
+
+	// the scan statistics match one DSL_FindNode per lookup
+	DSL_ResetScanStats(&list);
+	DSL_FindNodeBatch(&list, keys, 8, results);
+	size_t batchCount = list.findCount;
+	size_t batchDepth = list.findDepth;
+	DSL_ResetScanStats(&list);
+	for (int i = 0; i < 8; i++)
+		DSL_FindNode(&list, keys[i]);
+	assert(batchCount == 7 && batchCount == list.findCount && batchDepth == list.findDepth);
+
+	// the filter skips definite misses before the walk
+	assert(DSL_EnableFilter(&list, 40, 0.01) == 1);
+	assert(DSL_FindNodeBatch(&list, keys, 8, results) == 6);
+	for (int i = 0; i < 8; i++)
+		assert(results[i] == DSL_FindNode(&list, keys[i]));
+
+	DSL_FilterStats stats;
+	DSL_GetFilterStats(&list, &stats);
+	assert(stats.definiteMisses + stats.falsePositives == 2);
+
+	assert(DSL_FindNodeBatch(&list, keys, 0, results) == 0);
+
+	// self-organizing lists promote every hit like DSL_FindNode
+	DSL_DisableFilter(&list);
+	assert(DSL_SetSelfOrganizing(&list, DSL_ORGANIZE_MOVE_TO_FRONT, 0) == 1);
+	void* promoted[2] = { &values[30], &values[10] };
+	assert(DSL_FindNodeBatch(&list, promoted, 2, results) == 2);
+	assert(list.pHead == &nodes[10] && nodes[10].pNext == &nodes[30]);
+	assert(results[1] == &list.pHead);
+	DSL_DestroyList(&list, 0);
+	assert(DSL_FindNodeBatch(&list, keys, 8, results) == 0 && results[0] == NULL);
+	printf("  Test 20 - Find Node Batch - passed\n");
+}
+
+void testInlineFastPath()
+{
+	TestData values[4] = { {1}, {2}, {3}, {4} };
+	DSL_Node nodes[4];
+	DSL_List list;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &list, NULL);
+	for (int i = 0; i < 4; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_PushInline(&nodes[i], &list);
+	}
+	assert(list.length == 4 && list.pHead == &nodes[3] && list.pTail == &nodes[0]);
+	assert(*DSL_NextPointer(&nodes[3], list.offset) == &nodes[2]);
+	assert(*DSL_PrevPointer(&nodes[2], list.offset) == &nodes[3]);
+	assert(*DSL_DataPointer(&nodes[1], list.offset) == &values[1]);
+
+	// middle, tail and head removals leave the same links as DSL_RemoveNode
+	DSL_RemoveNodeInline(&nodes[2], &list);
+	assert(nodes[3].pNext == &nodes[1] && nodes[1].pPrev == &nodes[3]);
+	DSL_RemoveNodeInline(&nodes[0], &list);
+	assert(list.pTail == &nodes[1] && nodes[1].pNext == NULL);
+	assert(DSL_PopInline(&list) == &nodes[3]);
+	assert(list.pHead == &nodes[1] && nodes[1].pPrev == NULL);
+	assert(DSL_PopInline(&list) == &nodes[1]);
+	assert(list.length == 0 && list.pHead == NULL && list.pTail == NULL);
+	assert(DSL_PopInline(&list) == NULL);
+
+	// a filtered list goes through the library so the filter stays current
+	assert(DSL_EnableFilter(&list, 4, 0.01) == 1);
+	assert(DSL_IsPlainList(&list) == 0);
+	DSL_PushInline(&nodes[0], &list);
+	assert(DSL_Contains(&list, &values[0]) == 1);
+	assert(DSL_PopInline(&list) == &nodes[0]);
+	assert(DSL_Contains(&list, &values[0]) == 0);
+	DSL_DestroyList(&list, 0);
+	printf("  Test 21 - Inline Fast Path - passed\n");
+}
+
+void testSpillList()
+{
+	int released = 0;
+	DSL_SpillList list;
+	assert(DSL_InitSpillList(&list, OFFSETOF_DSL_NODE, orderFunction, 0, serializeSpillItem,
+							 deserializeSpillItem, freeSpillItem, &released) == 0);
+	assert(DSL_InitSpillList(&list, OFFSETOF_DSL_NODE, orderFunction, 16, serializeSpillItem,
+							 deserializeSpillItem, freeSpillItem, &released) == 1);
+
+	// only the resident list and one head per run stay in memory
+	for (int i = 0; i < 100; i++)
+	{
+		TestSpillItem* pItem = deserializeSpillItem(&(TestData){ (i * 37) % 101 }, sizeof(TestData), NULL);
+		assert(DSL_SpillInsert(&pItem->node, &list) == 1);
+		assert(list.resident.length <= 16);
+	}
+	assert(list.runCount == 6 && list.resident.length == 4);
+	assert(released == 96);
+	assert(DSL_SpillLength(&list) == 100);
+
+	// pops stream the runs and the resident list in order, inserts can interleave
+	int previous = -1;
+	for (int i = 0; i < 50; i++)
+	{
+		TestSpillItem* pItem = DSL_SpillPop(&list);
+		assert(pItem->data.number > previous);
+		previous = pItem->data.number;
+		free(pItem);
+	}
+	TestSpillItem* pLate = deserializeSpillItem(&(TestData){ 1000 }, sizeof(TestData), NULL);
+	assert(DSL_SpillInsert(&pLate->node, &list) == 1);
+	assert(((TestSpillItem*)DSL_SpillPeek(&list))->data.number > previous);
+
+	size_t popped = 0;
+	TestSpillItem* pItem;
+	while ((pItem = DSL_SpillPop(&list)) != NULL)
+	{
+		assert(pItem->data.number > previous);
+		previous = pItem->data.number;
+		free(pItem);
+		popped++;
+	}
+	assert(popped == 51 && previous == 1000);
+	assert(DSL_SpillLength(&list) == 0 && list.ioError == 0);
+	// drained runs are closed as soon as their last node is popped
+	assert(list.runCount == 0 && list.heapCount == 0);
+
+	// a spill that fails keeps its nodes resident and rejects the insert, so memory stays bounded
+	for (int i = 0; i < 16; i++)
+	{
+		TestSpillItem* pItem = deserializeSpillItem(&(TestData){ i }, sizeof(TestData), NULL);
+		assert(DSL_SpillInsert(&pItem->node, &list) == 1);
+	}
+	released = 0;
+	list.deserialize = failDeserialize;
+	for (int i = 0; i < 3; i++)
+	{
+		pItem = deserializeSpillItem(&(TestData){ 16 }, sizeof(TestData), NULL);
+		assert(DSL_SpillInsert(&pItem->node, &list) == 0);
+		free(pItem);
+	}
+	assert(list.ioError == 1 && released == 0 && list.runCount == 0);
+	assert(list.resident.length == 16 && DSL_SpillLength(&list) == 16);
+	list.deserialize = deserializeSpillItem;
+	pItem = deserializeSpillItem(&(TestData){ 16 }, sizeof(TestData), NULL);
+	assert(DSL_SpillInsert(&pItem->node, &list) == 1);
+	assert(released == 16 && list.resident.length == 1 && list.runCount == 1);
+	for (int i = 0; i <= 16; i++)
+	{
+		pItem = DSL_SpillPop(&list);
+		assert(pItem->data.number == i);
+		free(pItem);
+	}
+	assert(DSL_SpillLength(&list) == 0);
+
+	// whatever is left is released on destroy
+	for (int i = 0; i < 40; i++)
+	{
+		TestSpillItem* pItem = deserializeSpillItem(&(TestData){ i }, sizeof(TestData), NULL);
+		DSL_SpillInsert(&pItem->node, &list);
+	}
+	released = 0;
+	DSL_DestroySpillList(&list);
+	assert(released == 8 + 2);
+
+	// the newest runs of similar size are merged once maxOpenRuns is reached
+	assert(DSL_InitSpillList(&list, OFFSETOF_DSL_NODE, orderFunction, 4, serializeSpillItem,
+							 deserializeSpillItem, freeSpillItem, &released) == 1);
+	list.maxOpenRuns = 8;
+	spillRecordsWritten = 0;
+	for (int i = 0; i < 2000; i++)
+	{
+		TestSpillItem* pItem = deserializeSpillItem(&(TestData){ (i * 37) % 2003 }, sizeof(TestData), NULL);
+		assert(DSL_SpillInsert(&pItem->node, &list) == 1);
+		assert(list.runCount <= 8 && list.heapCount == list.runCount);
+	}
+	assert(DSL_SpillLength(&list) == 2000 && list.ioError == 0);
+	// large runs are not rewritten by every merge, merging every open run each time wrote about 73000
+	assert(spillRecordsWritten < 2000 * 8);
+
+	// a failed merge leaves the runs as they were and rejects the insert
+	int next = 3000;
+	while (list.runCount < 8 || list.resident.length < 4)
+	{
+		TestSpillItem* pItem = deserializeSpillItem(&(TestData){ next++ }, sizeof(TestData), NULL);
+		assert(DSL_SpillInsert(&pItem->node, &list) == 1);
+	}
+	list.deserialize = failDeserialize;
+	pItem = deserializeSpillItem(&(TestData){ next }, sizeof(TestData), NULL);
+	assert(DSL_SpillInsert(&pItem->node, &list) == 0);
+	free(pItem);
+	assert(list.ioError == 1 && list.runCount == 8 && list.heapCount == 8 && list.resident.length == 4);
+	list.deserialize = deserializeSpillItem;
+	size_t total = DSL_SpillLength(&list);
+	popped = 0;
+	previous = -1;
+	while ((pItem = DSL_SpillPop(&list)) != NULL)
+	{
+		assert(pItem->data.number > previous);
+		previous = pItem->data.number;
+		free(pItem);
+		popped++;
+	}
+	assert(popped == total && previous == next - 1 && list.runCount == 0);
+	DSL_DestroySpillList(&list);
+	printf("  Test 22 - Spill List - passed\n");
+}
+
+void testMergeK()
+{
+	TestData values[12] = { {5}, {1}, {9}, {3}, {3}, {7}, {2}, {8}, {3}, {0}, {6}, {4} };
+	DSL_Node nodes[12];
+	DSL_List sources[4];
+	DSL_List* pSources[4] = { &sources[0], &sources[1], &sources[2], &sources[3] };
+	DSL_List merged;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &merged, orderFunction);
+	for (int i = 0; i < 4; i++)
+		DSL_InitList(0, OFFSETOF_DSL_NODE, &sources[i], orderFunction);
+
+	// three nodes per source, list 3 stays empty, one node is already in the destination
+	for (int i = 0; i < 12; i++)
+	{
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		DSL_InsertNode(&nodes[i], i == 11 ? &merged : &sources[i % 3]);
+	}
+	assert(DSL_MergeK(pSources, 4, &merged) == 11);
+	assert(merged.length == 12);
+	for (int i = 0; i < 4; i++)
+		assert(sources[i].length == 0 && sources[i].pHead == NULL && sources[i].pTail == NULL);
+
+	int expected[12] = { 9, 1, 6, 3, 4, 8, 11, 0, 10, 5, 7, 2 };
+	DSL_Node* node = merged.pHead;
+	for (int i = 0; i < 12; i++)
+	{
+		// equal numbers keep the order of their source lists
+		assert(node == &nodes[expected[i]]);
+		assert(node->pPrev == (i == 0 ? NULL : &nodes[expected[i - 1]]));
+		node = node->pNext;
+	}
+	assert(merged.pTail == &nodes[2]);
+
+	// nothing moves when the layouts differ
+	DSL_List other;
+	DSL_InitList(0, sizeof(void*), &other, orderFunction);
+	DSL_List* pOther = &other;
+	assert(DSL_MergeK(&pOther, 1, &merged) == 0);
+
+	// nor when a list is given twice, the destination is a source, or the orders differ
+	DSL_InsertNode(DSL_Pop(&merged), &sources[0]);
+	DSL_List* pTwice[2] = { &sources[0], &sources[0] };
+	assert(DSL_MergeK(pTwice, 2, &merged) == 0);
+	DSL_List* pWithDestination[2] = { &sources[0], &merged };
+	assert(DSL_MergeK(pWithDestination, 2, &merged) == 0);
+	DSL_List unordered;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &unordered, NULL);
+	DSL_List* pMixed[2] = { &sources[0], &unordered };
+	assert(DSL_MergeK(pMixed, 2, &merged) == 0);
+	assert(sources[0].length == 1 && merged.length == 11);
+	assert(DSL_MergeK(pSources, 4, &merged) == 1 && merged.length == 12 && merged.pHead == &nodes[9]);
+	printf("  Test 23 - Merge K - passed\n");
+}
+
+void testSelfOrganizing()
+{
+	TestData values[5] = { {0}, {1}, {2}, {3}, {4} };
+	TestCountedNode nodes[5];
+	DSL_List list;
+	size_t offset = offsetof(TestCountedNode, pNext);
+
+	// ordered lists keep their order
+	DSL_InitList(0, offset, &list, orderFunction);
+	assert(DSL_SetSelfOrganizing(&list, DSL_ORGANIZE_MOVE_TO_FRONT, 0) == 0);
+	DSL_InitList(0, offset, &list, NULL);
+	assert(DSL_SetSelfOrganizing(&list, 7, 0) == 0);
+
+	for (int policy = DSL_ORGANIZE_NONE; policy <= DSL_ORGANIZE_COUNT; policy++)
+	{
+		DSL_InitList(0, offset, &list, NULL);
+		assert(DSL_SetSelfOrganizing(&list, policy, offsetof(TestCountedNode, count)) == 1);
+		for (int i = 0; i < 5; i++)
+		{
+			nodes[i] = (TestCountedNode){ &values[i], NULL, NULL, 0 };
+			DSL_InsertNode(&nodes[i], &list);
+		}
+
+		// 0 1 2 3 4, look up 3 twice and 4 once
+		void** pFound = DSL_FindNode(&list, &values[3]);
+		assert(*pFound == &nodes[3]);
+		assert(*DSL_FindNode(&list, &values[4]) == &nodes[4]);
+		assert(*DSL_FindNode(&list, &values[3]) == &nodes[3]);
+
+		int expected[4][5] = {
+			{ 0, 1, 2, 3, 4 },
+			{ 3, 4, 0, 1, 2 },
+			{ 0, 3, 1, 4, 2 },
+			{ 3, 4, 0, 1, 2 },
+		};
+		TestCountedNode* node = list.pHead;
+		for (int i = 0; i < 5; i++)
+		{
+			assert(node == &nodes[expected[policy][i]]);
+			assert(node->pPrev == (i == 0 ? NULL : &nodes[expected[policy][i - 1]]));
+			node = node->pNext;
+		}
+		assert(list.pTail == &nodes[expected[policy][4]] && list.length == 5);
+	}
+
+	// the count policy converges on the hot node, the average depth drops
+	DSL_ResetScanStats(&list);
+	assert(DSL_AverageScanDepth(&list) == 0.0);
+	assert(DSL_FindNode(&list, &values[2]) != NULL);
+	assert(DSL_AverageScanDepth(&list) == 2.0);
+	for (int i = 0; i < 3; i++)
+		DSL_FindNode(&list, &values[2]);
+	DSL_ResetScanStats(&list);
+	assert(*DSL_FindNode(&list, &values[2]) == &nodes[2] && list.pHead == &nodes[2]);
+	assert(DSL_AverageScanDepth(&list) == 1.0 && nodes[2].count == 5);
+	printf("  Test 24 - Self Organizing - passed\n");
+}
+
+void testSetOperations()
+{
+	const int a[] = { 1, 3, 3, 5, 7, 9 };
+	const int b[] = { 0, 3, 4, 7, 7, 10 };
+	TestData valuesA[6], valuesB[6];
+	DSL_Node nodesA[6], nodesB[6];
+	DSL_List listA, listB, discard;
+
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &discard, NULL);
+	buildNumberList(&listA, a, 6, valuesA, nodesA);
+	buildNumberList(&listB, b, 6, valuesB, nodesB);
+	assert(DSL_Intersect(&listA, &listB, &discard) == 3);
+	assertNumbers(&listA, (int[]){ 3, 3, 7 }, 3);
+	assertNumbers(&discard, (int[]){ 1, 5, 9 }, 3);
+	assertNumbers(&listB, b, 6);
+
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &discard, NULL);
+	buildNumberList(&listA, a, 6, valuesA, nodesA);
+	assert(DSL_Difference(&listA, &listB, &discard) == 3);
+	assertNumbers(&listA, (int[]){ 1, 5, 9 }, 3);
+	assertNumbers(&discard, (int[]){ 3, 3, 7 }, 3);
+
+	// pB's copies of numbers pA already holds are discarded, the rest move over
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &discard, NULL);
+	buildNumberList(&listA, a, 6, valuesA, nodesA);
+	assert(DSL_Union(&listA, &listB, &discard) == 3);
+	assertNumbers(&listA, (int[]){ 0, 1, 3, 3, 4, 5, 7, 9, 10 }, 9);
+	assertNumbers(&discard, (int[]){ 3, 7, 7 }, 3);
+	assert(listB.length == 0 && listB.pHead == NULL && listB.pTail == NULL);
+	assert(((DSL_Node*)discard.pHead)->pData == &valuesB[1]);
+
+	assert(DSL_Dedup(&listA, NULL) == 1);
+	assertNumbers(&listA, (int[]){ 0, 1, 3, 4, 5, 7, 9, 10 }, 8);
+	assert(nodesA[2].pNext == NULL && nodesA[2].pPrev == NULL);
+
+	// union into an empty list moves everything, the filter follows the nodes
+	DSL_List empty;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &empty, orderFunction);
+	assert(DSL_EnableFilter(&empty, 16, 0.01) == 1);
+	assert(DSL_Union(&empty, &listA, NULL) == 0);
+	assertNumbers(&empty, (int[]){ 0, 1, 3, 4, 5, 7, 9, 10 }, 8);
+	assert(DSL_Contains(&empty, &valuesB[0]) == 1 && DSL_Contains(&listA, &valuesB[0]) == 0);
+
+	// lists must be ordered and distinct
+	assert(DSL_Union(&empty, &empty, NULL) == 0);
+	assert(DSL_Dedup(&discard, NULL) == 0);
+	DSL_DestroyList(&empty, 0);
+	printf("  Test 25 - Set Operations - passed\n");
+}
+
+void testSortedVector()
+{
+	const int numbers[8] = { 5, 2, 8, 2, 9, 1, 7, 3 };
+	TestData values[8];
+	DSL_Node nodes[8];
+	DSL_SortedVector vector;
+	assert(DSL_InitSortedVector(&vector, NULL, 4) == 0);
+	assert(DSL_InitSortedVector(&vector, orderFunction, 4) == 1);
+
+	// equal elements keep their insertion order, like DSL_InsertNode
+	for (int i = 0; i < 8; i++)
+	{
+		values[i].number = numbers[i];
+		DSL_InitNode(0, &nodes[i], &values[i]);
+		assert(DSL_VectorInsert(&vector, &nodes[i]) == 1);
+	}
+	int expected[8] = { 5, 1, 3, 7, 0, 6, 2, 4 };
+	for (int i = 0; i < 8; i++)
+		assert(DSL_VectorAt(&vector, i) == &nodes[expected[i]]);
+	assert(DSL_VectorAt(&vector, 8) == NULL);
+
+	TestData key = { 2 };
+	DSL_Node keyNode;
+	DSL_InitNode(0, &keyNode, &key);
+	assert(DSL_VectorFind(&vector, &keyNode) == &nodes[1]);
+	assert(DSL_VectorRemove(&vector, &nodes[3]) == 1);
+	assert(DSL_VectorRemove(&vector, &nodes[3]) == 0);
+	key.number = 4;
+	assert(DSL_VectorFind(&vector, &keyNode) == NULL);
+
+	// pops free room at the front that later inserts reuse
+	assert(DSL_VectorPop(&vector) == &nodes[5]);
+	assert(DSL_VectorPop(&vector) == &nodes[1]);
+	assert(vector.first == 2 && vector.length == 5);
+	assert(DSL_VectorInsert(&vector, &nodes[3]) == 1);
+	assert(vector.first == 1 && DSL_VectorAt(&vector, 0) == &nodes[3]);
+	DSL_DestroySortedVector(&vector);
+
+	// the adaptive list turns into a linked list under writes and back under reads
+	DSL_AdaptiveList adaptive;
+	assert(DSL_InitAdaptiveList(&adaptive, OFFSETOF_DSL_NODE, orderFunction, 0) == 1);
+	assert(adaptive.useVector == 1 && adaptive.maxVectorLength == DSL_ADAPTIVE_MAX_VECTOR);
+	for (int i = 0; i < 8; i++)
+		DSL_AdaptiveInsert(&nodes[i], &adaptive);
+	for (int i = 0; i < DSL_ADAPTIVE_WINDOW; i++)
+	{
+		DSL_AdaptiveRemove(&nodes[i % 8], &adaptive);
+		DSL_AdaptiveInsert(&nodes[i % 8], &adaptive);
+	}
+	assert(adaptive.useVector == 0 && adaptive.switches == 1);
+	assert(DSL_AdaptiveLength(&adaptive) == 8 && adaptive.list.length == 8);
+
+	// removing a node the list doesn't hold fails and isn't counted as a write
+	size_t writes = adaptive.writes;
+	assert(DSL_AdaptiveRemove(&nodes[3], &adaptive) == 1);
+	assert(DSL_AdaptiveRemove(&nodes[3], &adaptive) == 0);
+	assert(adaptive.writes == writes + 1);
+	assert(DSL_AdaptiveInsert(&nodes[3], &adaptive) == 1);
+
+	// nor does removing a node that is linked into another list
+	DSL_Node strangers[2];
+	DSL_List other;
+	DSL_InitList(0, OFFSETOF_DSL_NODE, &other, orderFunction);
+	for (int i = 0; i < 2; i++)
+	{
+		DSL_InitNode(0, &strangers[i], &values[i]);
+		DSL_InsertNode(&strangers[i], &other);
+	}
+	assert(DSL_AdaptiveRemove(other.pHead, &adaptive) == 0);
+	assert(DSL_AdaptiveRemove(other.pTail, &adaptive) == 0);
+	assert(other.length == 2 && other.pHead != NULL && other.pTail != NULL);
+	assert(DSL_AdaptiveLength(&adaptive) == 8 && adaptive.writes == writes + 2);
+
+	key.number = 7;
+	for (int i = 0; i < DSL_ADAPTIVE_WINDOW; i++)
+		assert(DSL_AdaptiveFind(&adaptive, &keyNode) == &nodes[6]);
+	assert(adaptive.useVector == 1 && adaptive.switches == 2);
+	assert(adaptive.list.length == 0 && adaptive.vector.length == 8);
+	writes = adaptive.writes;
+	assert(DSL_AdaptiveRemove(&keyNode, &adaptive) == 0);
+	assert(adaptive.writes == writes);
+
+	int previous = 0;
+	for (int i = 0; i < 8; i++)
+	{
+		DSL_Node* node = DSL_AdaptivePop(&adaptive);
+		assert(((TestData*)node->pData)->number >= previous);
+		previous = ((TestData*)node->pData)->number;
+	}
+	assert(DSL_AdaptivePop(&adaptive) == NULL);
+	DSL_DestroyAdaptiveList(&adaptive);
+	printf("  Test 26 - Sorted Vector - passed\n");
+}